@@ -1,4 +1,4 @@
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -9,23 +9,45 @@ CONFIG += c++23
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    bufferpool.cpp \
+    commandlinetools.cpp \
+    filelistmodel.cpp \
+    filequeue.cpp \
     fileprocessorconfig.cpp \
     fileutils.cpp \
+    histogram.cpp \
+    logger.cpp \
+    logmodel.cpp \
     main.cpp \
     mainwindow.cpp \
+    processingcontroller.cpp \
     processingstatistics.cpp \
     worker.cpp
 
 HEADERS += \
+    bufferpool.h \
+    commandlinetools.h \
+    filelistmodel.h \
+    filemetrics.h \
+    filequeue.h \
     fileprocessorconfig.h \
     fileutils.h \
+    histogram.h \
+    logger.h \
+    logmodel.h \
     mainwindow.h \
+    processingcontroller.h \
+    processingsnapshot.h \
     processingstatistics.h \
+    ringbuffer.h \
     worker.h
 
 FORMS += \
     mainwindow.ui
 
+# The engine lives in the xorcore static library.
+include(xorcore/xorcore.pri)
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
@@ -0,0 +1,15 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    xorcore \
+    app \
+    numabench \
+    tests
+
+app.file = FileProcessor.pro
+app.depends = xorcore
+
+numabench.subdir = bench/numabench
+numabench.depends = xorcore
+
+tests.depends = xorcore
@@ -0,0 +1,145 @@
+#include "cputopology.h"
+#include "xorcodec.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include <barrier>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Placement
+{
+    int cpu = 0;
+    const CpuTopology::Node* memoryNode = nullptr;
+};
+
+// Every thread places its buffer on memoryNode (by running there while it
+// allocates), then moves to its own CPU and XORs the buffer passes times.
+// Returns the aggregate throughput in GB/s.
+double runXor(const std::vector<Placement>& placements, qint64 bufferSize, int passes)
+{
+    const QByteArray key = QByteArray::fromHex("0123456789ABCDEF");
+    std::barrier startLine(static_cast<std::ptrdiff_t>(placements.size() + 1));
+    std::vector<std::thread> threads;
+
+    for (const Placement& placement : placements) {
+        threads.emplace_back([&, placement]() {
+            CpuTopology::pinCurrentThread(placement.memoryNode->cpus);
+            char* buffer = CpuTopology::allocateOnNode(bufferSize, placement.memoryNode->id);
+            CpuTopology::pinCurrentThread({placement.cpu});
+
+            startLine.arrive_and_wait();
+            for (int pass = 0; pass != passes; ++pass) {
+                XorCodec::apply(buffer, bufferSize, key, 0);
+            }
+
+            CpuTopology::freeOnNode(buffer, bufferSize, placement.memoryNode->id);
+        });
+    }
+
+    startLine.arrive_and_wait();
+    const auto started = std::chrono::steady_clock::now();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+    const double totalBytes = double(bufferSize) * passes * placements.size();
+    return totalBytes / elapsed.count() / 1e9;
+}
+
+// Buffers are made smaller when a run would otherwise hold more than
+// maxMemory in total, so one thread per CPU stays affordable on large hosts.
+qint64 bufferSizeFor(qsizetype threadCount, qint64 bufferSize, qint64 maxMemory)
+{
+    const qint64 share = maxMemory / qMax<qsizetype>(1, threadCount) / CpuTopology::pageSize * CpuTopology::pageSize;
+    return qMax(CpuTopology::pageSize, qMin(bufferSize, share));
+}
+
+QList<int> threadCounts(int cpuCount)
+{
+    QList<int> counts;
+    for (int count = 1; count < cpuCount; count *= 2) {
+        counts.append(count);
+    }
+    counts.append(cpuCount);
+    return counts;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption sizeOption("size", "Buffer size per thread in megabytes.", "mb", "64");
+    QCommandLineOption passesOption("passes", "Passes over each buffer.", "n", "16");
+    QCommandLineOption maxMemoryOption("max-memory",
+                                       "Most memory a run may use in megabytes; buffers shrink to fit.",
+                                       "mb", "4096");
+    parser.addOption(sizeOption);
+    parser.addOption(passesOption);
+    parser.addOption(maxMemoryOption);
+    parser.process(app);
+
+    const qint64 bufferSize = qMax(1LL, parser.value(sizeOption).toLongLong()) * 1024 * 1024;
+    const qint64 maxMemory = qMax(1LL, parser.value(maxMemoryOption).toLongLong()) * 1024 * 1024;
+    const int passes = qMax(1, parser.value(passesOption).toInt());
+    const QList<CpuTopology::Node> nodes = CpuTopology::nodes();
+
+    QTextStream out(stdout);
+    out << "nodes: " << nodes.size() << "\n";
+    for (const CpuTopology::Node& node : nodes) {
+        out << "  node " << node.id << ": cpus " << CpuTopology::formatCpuList(node.cpus) << "\n";
+    }
+    out << "\nnode\tmemory\tthreads\tKB/thread\tGB/s\n";
+    out.flush();
+
+    // Scaling within each socket, with the buffers on the same node and, on
+    // NUMA machines, on the next one.
+    for (qsizetype n = 0; n != nodes.size(); ++n) {
+        const CpuTopology::Node& node = nodes.at(n);
+        const CpuTopology::Node& remoteNode = nodes.at((n + 1) % nodes.size());
+
+        for (int threadCount : threadCounts(static_cast<int>(node.cpus.size()))) {
+            std::vector<Placement> local;
+            std::vector<Placement> remote;
+            for (int i = 0; i != threadCount; ++i) {
+                local.push_back({node.cpus.at(i), &node});
+                remote.push_back({node.cpus.at(i), &remoteNode});
+            }
+
+            const qint64 runBufferSize = bufferSizeFor(threadCount, bufferSize, maxMemory);
+            out << node.id << "\tlocal\t" << threadCount << "\t" << runBufferSize / 1024 << "\t"
+                << QString::number(runXor(local, runBufferSize, passes), 'f', 2) << "\n";
+            out.flush();
+            if (nodes.size() > 1) {
+                out << node.id << "\tnode " << remoteNode.id << "\t" << threadCount << "\t" << runBufferSize / 1024 << "\t"
+                    << QString::number(runXor(remote, runBufferSize, passes), 'f', 2) << "\n";
+                out.flush();
+            }
+        }
+    }
+
+    // All sockets at once, one thread per CPU with node-local buffers.
+    if (nodes.size() > 1) {
+        std::vector<Placement> all;
+        for (const CpuTopology::Node& node : nodes) {
+            for (int cpu : node.cpus) {
+                all.push_back({cpu, &node});
+            }
+        }
+        const qint64 runBufferSize = bufferSizeFor(static_cast<qsizetype>(all.size()), bufferSize, maxMemory);
+        out << "all\tlocal\t" << all.size() << "\t" << runBufferSize / 1024 << "\t"
+            << QString::number(runXor(all, runBufferSize, passes), 'f', 2) << "\n";
+    }
+
+    return 0;
+}
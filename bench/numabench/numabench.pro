@@ -0,0 +1,17 @@
+# Per-socket scaling of the XOR kernel with node-local and remote buffers.
+#   numabench [--size <mb>] [--passes <n>] [--max-memory <mb>]
+# A run never allocates more than --max-memory (4096 MB by default) in total:
+# with many threads the per-thread buffers are made smaller.
+
+QT       = core
+
+TEMPLATE = app
+CONFIG += console c++23
+CONFIG -= app_bundle
+
+TARGET = numabench
+
+SOURCES += \
+    main.cpp
+
+include(../../xorcore/xorcore.pri)
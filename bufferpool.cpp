@@ -0,0 +1,142 @@
+#include "bufferpool.h"
+
+#include <utility>
+
+BufferPool::Buffer::Buffer(Buffer&& other) noexcept
+    : m_pool(std::exchange(other.m_pool, nullptr))
+    , m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+    , m_charge(std::exchange(other.m_charge, 0))
+{}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(Buffer&& other) noexcept
+{
+    if (this != &other) {
+        if (m_pool) {
+            m_pool->release(m_data, m_charge);
+        }
+        m_pool = std::exchange(other.m_pool, nullptr);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_charge = std::exchange(other.m_charge, 0);
+    }
+    return *this;
+}
+
+BufferPool::Buffer::~Buffer()
+{
+    if (m_pool) {
+        m_pool->release(m_data, m_charge);
+    }
+}
+
+BufferPool::BufferPool(qint64 bufferSize, qint64 capacity, int numaNode)
+    : m_bufferSize((bufferSize + pageSize - 1) / pageSize * pageSize)
+    , m_numaNode(numaNode)
+    , m_capacity(qMax(capacity, m_bufferSize))
+{}
+
+BufferPool::~BufferPool()
+{
+    Q_ASSERT(m_inUse == 0);
+    for (char* data : std::as_const(m_freeBuffers)) {
+        deallocate(data);
+    }
+}
+
+void BufferPool::setCapacity(qint64 capacity)
+{
+    QMutexLocker locker(&m_mutex);
+    m_capacity = qMax(capacity, m_bufferSize);
+    trimLocked();
+    m_bufferReleased.wakeAll();
+}
+
+qint64 BufferPool::capacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacity;
+}
+
+BufferPool::Buffer BufferPool::acquire(qint64 charge)
+{
+    QMutexLocker locker(&m_mutex);
+
+    charge = qBound<qint64>(0, charge, m_capacity - m_bufferSize);
+
+    // Idle buffers do not count: they are freed below to make room.
+    bool hasWaited = false;
+    while (m_inUse + m_bufferSize + charge > m_capacity) {
+        if (!hasWaited) {
+            m_waitCount++;
+            hasWaited = true;
+        }
+        m_bufferReleased.wait(&m_mutex);
+        charge = qMin(charge, m_capacity - m_bufferSize);
+    }
+
+    char* data = nullptr;
+    if (!m_freeBuffers.isEmpty()) {
+        data = m_freeBuffers.takeLast();
+    } else {
+        data = allocate();
+        m_allocated += m_bufferSize;
+    }
+
+    m_inUse += m_bufferSize + charge;
+    m_charged += charge;
+    m_peakInUse = qMax(m_peakInUse, m_inUse);
+    trimLocked();
+    return Buffer(this, data, m_bufferSize, charge);
+}
+
+BufferPool::Usage BufferPool::usage() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    Usage usage;
+    usage.capacity = m_capacity;
+    usage.allocated = m_allocated;
+    usage.inUse = m_inUse;
+    usage.peakInUse = m_peakInUse;
+    usage.waitCount = m_waitCount;
+    return usage;
+}
+
+void BufferPool::resetCounters()
+{
+    QMutexLocker locker(&m_mutex);
+    m_peakInUse = m_inUse;
+    m_waitCount = 0;
+}
+
+// Waiters ask for different amounts, so all of them get to re-check.
+void BufferPool::release(char* data, qint64 charge)
+{
+    QMutexLocker locker(&m_mutex);
+    m_inUse -= m_bufferSize + charge;
+    m_charged -= charge;
+    m_freeBuffers.append(data);
+    trimLocked();
+    m_bufferReleased.wakeAll();
+}
+
+void BufferPool::trimLocked()
+{
+    while (m_allocated + m_charged > m_capacity && !m_freeBuffers.isEmpty()) {
+        deallocate(m_freeBuffers.takeLast());
+        m_allocated -= m_bufferSize;
+    }
+}
+
+// Runs on the acquiring worker's thread, which is what makes first-touch
+// placement land on the worker's node.
+char* BufferPool::allocate()
+{
+    return CpuTopology::allocateOnNode(m_bufferSize, m_numaNode);
+}
+
+void BufferPool::deallocate(char* data)
+{
+    CpuTopology::freeOnNode(data, m_bufferSize, m_numaNode);
+}
@@ -0,0 +1,97 @@
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+#include "cputopology.h"
+
+// Fixed-size, page-aligned I/O buffers shared by all workers. Buffers are
+// reused across files instead of being allocated per file, and the memory in
+// use never exceeds the capacity: acquire() blocks until other workers have
+// released enough. A buffer can carry a charge for memory the worker holds
+// next to it (compression batches), counted against the same capacity until
+// the buffer is released. A worker holds at most one buffer at a time and a
+// charge is cut down to what fits next to one buffer, so no request can wait
+// forever. A pool bound to a NUMA node places its buffers there (see
+// CpuTopology::allocateOnNode), so it should only serve workers pinned to
+// that node.
+class BufferPool
+{
+public:
+    static constexpr qint64 pageSize = CpuTopology::pageSize;
+
+    class Buffer
+    {
+    public:
+        Buffer() = default;
+        Buffer(Buffer&& other) noexcept;
+        Buffer& operator=(Buffer&& other) noexcept;
+        ~Buffer();
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        char* data() const { return m_data; }
+        qint64 size() const { return m_size; }
+        qint64 charge() const { return m_charge; }
+
+    private:
+        friend class BufferPool;
+        Buffer(BufferPool* pool, char* data, qint64 size, qint64 charge)
+            : m_pool(pool), m_data(data), m_size(size), m_charge(charge) {}
+
+        BufferPool* m_pool = nullptr;
+        char* m_data = nullptr;
+        qint64 m_size = 0;
+        qint64 m_charge = 0;
+    };
+
+    struct Usage
+    {
+        qint64 capacity = 0;
+        qint64 allocated = 0;
+        qint64 inUse = 0; // buffers handed out plus their charges
+        qint64 peakInUse = 0;
+        qint64 waitCount = 0;
+    };
+
+    BufferPool(qint64 bufferSize, qint64 capacity, int numaNode = -1);
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    qint64 bufferSize() const { return m_bufferSize; }
+    int numaNode() const { return m_numaNode; }
+    qint64 capacity() const;
+
+    // Lowering the capacity frees idle buffers right away; buffers in use are
+    // freed as they come back.
+    void setCapacity(qint64 capacity);
+
+    Buffer acquire(qint64 charge = 0);
+    Usage usage() const;
+    void resetCounters();
+
+private:
+    const qint64 m_bufferSize;
+    const int m_numaNode;
+    qint64 m_capacity;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_bufferReleased;
+    QList<char*> m_freeBuffers;
+    qint64 m_allocated = 0;
+    qint64 m_inUse = 0;
+    qint64 m_charged = 0;
+    qint64 m_peakInUse = 0;
+    qint64 m_waitCount = 0;
+
+    void release(char* data, qint64 charge);
+    void trimLocked();
+    char* allocate();
+    void deallocate(char* data);
+};
+
+#endif // BUFFERPOOL_H
@@ -0,0 +1,216 @@
+#include "commandlinetools.h"
+#include "segmentreader.h"
+#include "chunkcodec.h"
+#include "xoriodevice.h"
+#include "xorpipe.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+int runSegmentExtractor(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption extractOption("extract", "Directory with packed segments.", "dir");
+    QCommandLineOption targetOption("extract-to", "Directory to extract entries into.", "dir");
+    QCommandLineOption keyOption("key", "XOR key (16 hex characters) to decode entries with.", "hex");
+    QCommandLineOption entryOption("entry", "Extract only this entry (may be repeated).", "name");
+    parser.addOption(extractOption);
+    parser.addOption(targetOption);
+    parser.addOption(keyOption);
+    parser.addOption(entryOption);
+    parser.process(arguments);
+
+    QTextStream err(stderr);
+
+    const QByteArray xorKey = QByteArray::fromHex(parser.value(keyOption).toLatin1());
+    if (parser.isSet(keyOption) && xorKey.size() != 8) {
+        err << "XOR ключ должен содержать ровно 16 hex-символов (8 байт)\n";
+        return 1;
+    }
+
+    SegmentReader reader;
+    QString errorMessage;
+    if (!reader.open(parser.value(extractOption), &errorMessage)) {
+        err << errorMessage << "\n";
+        return 1;
+    }
+
+    QDir targetDir(parser.value(targetOption));
+    if (!parser.isSet(targetOption) || !targetDir.mkpath(".")) {
+        err << "Укажите выходную директорию (--extract-to)\n";
+        return 1;
+    }
+
+    const QStringList names = parser.isSet(entryOption) ? parser.values(entryOption) : reader.entryNames();
+    QString targetRoot = QDir::cleanPath(targetDir.absolutePath());
+    if (!targetRoot.endsWith('/')) {
+        targetRoot += '/';
+    }
+    int failedCount = 0;
+
+    for (const QString& name : names) {
+        // Entry names come from the index and must not lead out of the target.
+        const QString outputFilePath = QDir::cleanPath(targetDir.absoluteFilePath(name));
+        if (name.isEmpty() || QDir::isAbsolutePath(name) || !outputFilePath.startsWith(targetRoot)) {
+            err << "Недопустимое имя записи: " << name << "\n";
+            failedCount++;
+            continue;
+        }
+
+        if (!reader.extract(name, outputFilePath, xorKey, &errorMessage)) {
+            err << errorMessage << "\n";
+            failedCount++;
+        }
+    }
+
+    return failedCount == 0 ? 0 : 1;
+}
+
+int runStreamDecoder(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption decodeOption("decode", "File written by the processor.", "file");
+    QCommandLineOption targetOption("decode-to", "File to write the decoded data to.", "file");
+    QCommandLineOption keyOption("key", "XOR key (16 hex characters) the file was written with.", "hex");
+    QCommandLineOption compressedOption("compressed", "The file was written with compression enabled.");
+    parser.addOption(decodeOption);
+    parser.addOption(targetOption);
+    parser.addOption(keyOption);
+    parser.addOption(compressedOption);
+    parser.process(arguments);
+
+    QTextStream err(stderr);
+
+    const QByteArray xorKey = QByteArray::fromHex(parser.value(keyOption).toLatin1());
+    if (xorKey.size() != 8) {
+        err << "XOR ключ должен содержать ровно 16 hex-символов (8 байт)\n";
+        return 1;
+    }
+
+    QFile inputFile(parser.value(decodeOption));
+    if (!inputFile.open(QIODevice::ReadOnly)) {
+        err << "Не удалось открыть входной файл: " << inputFile.fileName() << "\n";
+        return 1;
+    }
+
+    QFile outputFile(parser.value(targetOption));
+    if (!parser.isSet(targetOption) || !outputFile.open(QIODevice::WriteOnly)) {
+        err << "Не удалось создать выходной файл: " << outputFile.fileName() << "\n";
+        return 1;
+    }
+
+    QByteArray buffer(1024 * 1024, Qt::Uninitialized);
+
+    // Plain output carries no header, so the format is never guessed from the
+    // data: it is undone by reading it back through the XOR device.
+    if (!parser.isSet(compressedOption)) {
+        XorIODevice decodedInput(&inputFile, xorKey);
+        bool isDecoded = decodedInput.open(QIODevice::ReadOnly);
+
+        while (isDecoded && !decodedInput.atEnd()) {
+            const qint64 bytesRead = decodedInput.read(buffer.data(), buffer.size());
+            isDecoded = bytesRead >= 0 && outputFile.write(buffer.constData(), bytesRead) == bytesRead;
+        }
+
+        if (!isDecoded) {
+            err << "Ошибка записи в файл: " << outputFile.fileName() << "\n";
+            outputFile.remove();
+            return 1;
+        }
+        return 0;
+    }
+
+    ChunkDecoder decoder(xorKey, [&outputFile](const char* data, qint64 size) {
+        return outputFile.write(data, size) == size;
+    });
+
+    bool isDecoded = true;
+
+    while (isDecoded && !inputFile.atEnd()) {
+        const qint64 bytesRead = inputFile.read(buffer.data(), buffer.size());
+        isDecoded = bytesRead >= 0 && decoder.write(buffer.constData(), bytesRead);
+    }
+
+    if (!isDecoded || !decoder.finish()) {
+        err << (decoder.errorString().isEmpty() ? "Ошибка чтения из файла" : decoder.errorString()) << "\n";
+        outputFile.remove();
+        return 1;
+    }
+
+    return 0;
+}
+
+int runPipeMode(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption pipeOption("pipe", "XOR a stream instead of watching a directory.");
+    QCommandLineOption keyOption("key", "XOR key (16 hex characters).", "hex");
+    QCommandLineOption inputOption("input", "Read from this file or FIFO instead of stdin.", "file");
+    QCommandLineOption outputOption("output", "Write to this file or FIFO instead of stdout.", "file");
+    QCommandLineOption pipeSizeOption("pipe-size", "Pipe buffer size to request, in kilobytes.", "kb", "1024");
+    QCommandLineOption noVmspliceOption("no-vmsplice",
+                                        "Copy into the output pipe instead of lending pages to it "
+                                        "(needed when the reader splices them onward).");
+    parser.addOption(pipeOption);
+    parser.addOption(keyOption);
+    parser.addOption(inputOption);
+    parser.addOption(outputOption);
+    parser.addOption(pipeSizeOption);
+    parser.addOption(noVmspliceOption);
+    parser.process(arguments);
+
+    QTextStream err(stderr);
+
+    const QByteArray xorKey = QByteArray::fromHex(parser.value(keyOption).toLatin1());
+    if (xorKey.size() != 8) {
+        err << "XOR ключ должен содержать ровно 16 hex-символов (8 байт)\n";
+        return 1;
+    }
+
+#ifdef Q_OS_WIN
+    _setmode(0, _O_BINARY);
+    _setmode(1, _O_BINARY);
+#endif
+
+    QFile inputFile(parser.value(inputOption));
+    int inputFd = 0;
+    if (parser.isSet(inputOption)) {
+        if (!inputFile.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            err << "Не удалось открыть входной файл: " << inputFile.fileName() << "\n";
+            return 1;
+        }
+        inputFd = inputFile.handle();
+    }
+
+    QFile outputFile(parser.value(outputOption));
+    int outputFd = 1;
+    if (parser.isSet(outputOption)) {
+        if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+            err << "Не удалось создать выходной файл: " << outputFile.fileName() << "\n";
+            return 1;
+        }
+        outputFd = outputFile.handle();
+    }
+
+    XorPipe::Options options;
+    options.pipeSize = qMax(4LL, parser.value(pipeSizeOption).toLongLong()) * 1024;
+    options.useVmsplice = !parser.isSet(noVmspliceOption);
+
+    QString errorMessage;
+    if (!XorPipe::run(inputFd, outputFd, xorKey, options, nullptr, &errorMessage)) {
+        err << errorMessage << "\n";
+        return 1;
+    }
+
+    return 0;
+}
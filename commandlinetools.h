@@ -0,0 +1,14 @@
+#ifndef COMMANDLINETOOLS_H
+#define COMMANDLINETOOLS_H
+
+#include <QStringList>
+
+// Command-line clients of the xorcore library:
+//   FileProcessor --extract <segment dir> --extract-to <dir> [--key <hex>] [--entry <name>...]
+//   FileProcessor --decode <file> --decode-to <file> --key <hex>
+//   FileProcessor --pipe --key <hex> [--input <file>] [--output <file>] [--pipe-size <kb>] [--no-vmsplice]
+int runSegmentExtractor(const QStringList& arguments);
+int runStreamDecoder(const QStringList& arguments);
+int runPipeMode(const QStringList& arguments);
+
+#endif // COMMANDLINETOOLS_H
@@ -0,0 +1,471 @@
+#include "filelistmodel.h"
+#include "fileutils.h"
+
+#include <QBrush>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace {
+
+// Cuts on a character boundary so a long name never ends in half a sequence.
+QByteArray truncatedUtf8(const QString& text, qsizetype maxBytes)
+{
+    QByteArray bytes = text.toUtf8();
+    if (bytes.size() <= maxBytes) {
+        return bytes;
+    }
+
+    qsizetype length = maxBytes;
+    while (length > 0 && (static_cast<uchar>(bytes.at(length)) & 0xC0) == 0x80) {
+        --length;
+    }
+    bytes.truncate(length);
+    return bytes;
+}
+
+} // namespace
+
+FileListModel::FileListModel(QObject *parent)
+    : QAbstractListModel{parent}
+    , m_publishTimer(new QTimer(this))
+{
+    m_publishTimer->setSingleShot(true);
+    m_publishTimer->setInterval(publishInterval);
+    connect(m_publishTimer, &QTimer::timeout, this, &FileListModel::publishPending);
+    connect(&m_viewWatcher, &QFutureWatcher<QList<int>>::finished, this, &FileListModel::onViewComputed);
+}
+
+int FileListModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_hasCustomView ? static_cast<int>(m_viewRows.size()) : m_publishedCount;
+}
+
+QVariant FileListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    const int fileId = fileIdForRow(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return m_columns.inputName(fileId) + " -> " + m_columns.outputName(fileId);
+    case Qt::ToolTipRole: {
+        static const char* const statusNames[] = { "в очереди", "обрабатывается", "обработан", "ошибка" };
+        QString toolTip = m_directories.at(m_columns.directoryIds.at(fileId)) + "/" + m_columns.inputName(fileId);
+        toolTip += "\n" + FileUtils::formatFileSize(m_columns.sizes.at(fileId));
+        toolTip += "\n" + QString(statusNames[m_columns.statuses.at(fileId)]);
+        if (m_columns.statuses.at(fileId) == Done) {
+            toolTip += QString(", %1 мс").arg(m_columns.durationsUs.at(fileId) / 1000.0, 0, 'f', 2);
+        }
+        return toolTip;
+    }
+    case Qt::ForegroundRole:
+        if (m_columns.statuses.at(fileId) == Failed) {
+            return QBrush(Qt::red);
+        }
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+int FileListModel::addFile(const QString& directory, const QString& inputName,
+                           const QString& outputName, qint64 size)
+{
+    auto directoryIt = m_directoryIds.constFind(directory);
+    if (directoryIt == m_directoryIds.constEnd()) {
+        directoryIt = m_directoryIds.insert(directory, static_cast<quint32>(m_directories.size()));
+        m_directories.append(directory);
+    }
+
+    const QByteArray input = truncatedUtf8(inputName, 0xFFFF);
+    const QByteArray output = outputName == inputName ? QByteArray() : truncatedUtf8(outputName, 0xFFFF);
+
+    m_columns.nameOffsets.append(m_columns.names.size());
+    m_columns.names.append(input);
+    m_columns.names.append(output);
+    m_columns.inputNameLengths.append(static_cast<quint16>(input.size()));
+    m_columns.outputNameLengths.append(static_cast<quint16>(output.size()));
+    m_columns.directoryIds.append(directoryIt.value());
+    m_columns.sizes.append(size);
+    m_columns.durationsUs.append(0);
+    m_columns.statuses.append(Processing);
+
+    if (!m_publishTimer->isActive()) {
+        m_publishTimer->start();
+    }
+
+    return m_firstFileId + m_columns.count() - 1;
+}
+
+void FileListModel::setStatus(int fileId, Status status, qint64 durationUs)
+{
+    fileId -= m_firstFileId;
+    if (fileId < 0 || fileId >= m_columns.count()) {
+        return;
+    }
+
+    const quint32 duration = static_cast<quint32>(qMin<qint64>(durationUs, std::numeric_limits<quint32>::max()));
+    if (m_sortKey == ByDuration && fileId < m_viewComputedCount && m_columns.durationsUs.at(fileId) != duration) {
+        m_movedFileIds.insert(fileId);
+    }
+
+    m_columns.statuses[fileId] = status;
+    m_columns.durationsUs[fileId] = duration;
+
+    m_firstChangedId = m_firstChangedId == -1 ? fileId : qMin(m_firstChangedId, fileId);
+    m_lastChangedId = qMax(m_lastChangedId, fileId);
+
+    if (!m_publishTimer->isActive()) {
+        m_publishTimer->start();
+    }
+}
+
+void FileListModel::clear()
+{
+    beginResetModel();
+    m_columns = Columns();
+    m_firstFileId = 0;
+    m_directories.clear();
+    m_directoryIds.clear();
+    m_publishedCount = 0;
+    m_viewComputedCount = 0;
+    m_firstChangedId = -1;
+    m_lastChangedId = -1;
+    m_viewRows.clear();
+    m_movedFileIds.clear();
+    m_isViewDirty = m_isViewComputing;
+    endResetModel();
+}
+
+void FileListModel::setFilterText(const QString& text)
+{
+    m_filterText = text.trimmed();
+    recomputeView();
+}
+
+void FileListModel::setSortKey(int sortKey)
+{
+    m_sortKey = static_cast<SortKey>(sortKey);
+    recomputeView();
+}
+
+void FileListModel::publishPending()
+{
+    if (m_columns.count() > maxFiles) {
+        dropOldestFiles(m_columns.count() - maxFiles * 3 / 4);
+    }
+
+    const bool hasChanges = m_firstChangedId != -1;
+
+    if (m_hasCustomView) {
+        if (!m_isViewComputing) {
+            updateView();
+        }
+        if (hasChanges && !m_viewRows.isEmpty()) {
+            emit dataChanged(index(0), index(static_cast<int>(m_viewRows.size()) - 1));
+        }
+    } else {
+        if (m_columns.count() > m_publishedCount) {
+            beginInsertRows(QModelIndex(), m_publishedCount, m_columns.count() - 1);
+            m_publishedCount = m_columns.count();
+            endInsertRows();
+        }
+        if (hasChanges) {
+            emit dataChanged(index(m_firstChangedId), index(m_lastChangedId));
+        }
+    }
+
+    m_firstChangedId = -1;
+    m_lastChangedId = -1;
+}
+
+void FileListModel::recomputeView()
+{
+    if (m_isViewComputing) {
+        m_isViewDirty = true;
+        return;
+    }
+
+    m_movedFileIds.clear();
+
+    if (m_filterText.isEmpty() && m_sortKey == ByArrival) {
+        beginResetModel();
+        m_hasCustomView = false;
+        m_viewRows.clear();
+        m_publishedCount = m_columns.count();
+        endResetModel();
+        return;
+    }
+
+    // The columns are handed over as a shallow copy; only the first update
+    // of each column while the view is being computed detaches it.
+    m_viewComputedCount = m_columns.count();
+    m_isViewComputing = true;
+    m_viewWatcher.setFuture(QtConcurrent::run(&FileListModel::computeView,
+                                              m_columns, m_columns.count(), m_filterText, m_sortKey));
+}
+
+void FileListModel::onViewComputed()
+{
+    m_isViewComputing = false;
+
+    if (m_isViewDirty) {
+        m_isViewDirty = false;
+        recomputeView();
+        return;
+    }
+
+    if (m_filterText.isEmpty() && m_sortKey == ByArrival) {
+        return;
+    }
+
+    beginResetModel();
+    m_viewRows = m_viewWatcher.result();
+    m_hasCustomView = true;
+    endResetModel();
+
+    // Catch up with files added or re-timed while the view was computed.
+    updateView();
+}
+
+// Keeps the custom view current without recomputing it: new files that pass
+// the filter and files whose sort key changed are merged into the existing
+// order, and views keep their selection and scroll position.
+void FileListModel::updateView()
+{
+    QList<int> movedRows;
+    for (int fileId = m_viewComputedCount; fileId < m_columns.count(); ++fileId) {
+        if (matchesFilter(m_columns, fileId, m_filterText)) {
+            movedRows.append(fileId);
+        }
+    }
+    const qsizetype newRowCount = movedRows.size();
+    m_viewComputedCount = m_columns.count();
+
+    if (movedRows.isEmpty() && m_movedFileIds.isEmpty()) {
+        return;
+    }
+
+    QList<int> remainingRows;
+    if (m_movedFileIds.isEmpty()) {
+        remainingRows = m_viewRows;
+    } else {
+        remainingRows.reserve(m_viewRows.size());
+        for (int fileId : std::as_const(m_viewRows)) {
+            if (m_movedFileIds.contains(fileId)) {
+                movedRows.append(fileId);
+            } else {
+                remainingRows.append(fileId);
+            }
+        }
+        m_movedFileIds.clear();
+    }
+
+    // New rows are first appended, so the row count changes through a plain
+    // insertion, and then moved into place by a layout change.
+    if (newRowCount > 0) {
+        const int first = static_cast<int>(m_viewRows.size());
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(newRowCount) - 1);
+        m_viewRows.append(movedRows.first(newRowCount));
+        endInsertRows();
+    }
+
+    const auto isBefore = [this](int left, int right) {
+        return isOrderedBefore(m_columns, m_sortKey, left, right);
+    };
+    std::sort(movedRows.begin(), movedRows.end(), isBefore);
+
+    QList<int> rows;
+    rows.reserve(m_viewRows.size());
+    auto position = remainingRows.cbegin();
+    for (int fileId : std::as_const(movedRows)) {
+        const auto next = std::lower_bound(position, remainingRows.cend(), fileId, isBefore);
+        std::copy(position, next, std::back_inserter(rows));
+        rows.append(fileId);
+        position = next;
+    }
+    std::copy(position, remainingRows.cend(), std::back_inserter(rows));
+
+    if (rows != m_viewRows) {
+        reorderView(rows);
+    }
+}
+
+void FileListModel::reorderView(const QList<int>& rows)
+{
+    emit layoutAboutToBeChanged();
+
+    QList<int> newRows(m_columns.count(), -1);
+    for (qsizetype row = 0; row != rows.size(); ++row) {
+        newRows[rows.at(row)] = static_cast<int>(row);
+    }
+
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+    for (const QModelIndex& oldIndex : oldIndexes) {
+        newIndexes.append(index(newRows.at(m_viewRows.at(oldIndex.row()))));
+    }
+
+    m_viewRows = rows;
+    changePersistentIndexList(oldIndexes, newIndexes);
+
+    emit layoutChanged();
+}
+
+void FileListModel::dropOldestFiles(int count)
+{
+    beginResetModel();
+
+    const qint64 nameBase = m_columns.nameOffsets.at(count);
+    m_columns.names.remove(0, nameBase);
+    m_columns.nameOffsets.remove(0, count);
+    for (qint64& offset : m_columns.nameOffsets) {
+        offset -= nameBase;
+    }
+    m_columns.inputNameLengths.remove(0, count);
+    m_columns.outputNameLengths.remove(0, count);
+    m_columns.directoryIds.remove(0, count);
+    m_columns.sizes.remove(0, count);
+    m_columns.durationsUs.remove(0, count);
+    m_columns.statuses.remove(0, count);
+    m_firstFileId += count;
+
+    m_publishedCount = qMax(0, m_publishedCount - count);
+    m_viewComputedCount = qMax(0, m_viewComputedCount - count);
+
+    if (m_lastChangedId < count) {
+        m_firstChangedId = -1;
+        m_lastChangedId = -1;
+    } else {
+        m_firstChangedId = qMax(0, m_firstChangedId - count);
+        m_lastChangedId -= count;
+    }
+
+    if (m_hasCustomView) {
+        QList<int> rows;
+        rows.reserve(m_viewRows.size());
+        for (int row : std::as_const(m_viewRows)) {
+            if (row >= count) {
+                rows.append(row - count);
+            }
+        }
+        m_viewRows = rows;
+    }
+
+    QSet<int> movedFileIds;
+    for (int fileId : std::as_const(m_movedFileIds)) {
+        if (fileId >= count) {
+            movedFileIds.insert(fileId - count);
+        }
+    }
+    m_movedFileIds = movedFileIds;
+
+    // A view being computed still indexes the old columns.
+    m_isViewDirty = m_isViewDirty || m_isViewComputing;
+
+    endResetModel();
+}
+
+int FileListModel::fileIdForRow(int row) const
+{
+    return m_hasCustomView ? m_viewRows.at(row) : row;
+}
+
+QList<int> FileListModel::computeView(const Columns& columns, int count,
+                                      const QString& filterText, SortKey sortKey)
+{
+    QList<int> rows;
+    rows.reserve(count);
+
+    for (int fileId = 0; fileId != count; ++fileId) {
+        if (matchesFilter(columns, fileId, filterText)) {
+            rows.append(fileId);
+        }
+    }
+
+    // Ties are broken by arrival, the same total order updateView() merges into.
+    switch (sortKey) {
+    case ByName: {
+        QList<std::pair<QString, int>> names;
+        names.reserve(rows.size());
+        for (int fileId : rows) {
+            names.append({ columns.inputName(fileId), fileId });
+        }
+        std::stable_sort(names.begin(), names.end(), [](const auto& left, const auto& right) {
+            return QString::compare(left.first, right.first, Qt::CaseInsensitive) < 0;
+        });
+        for (qsizetype i = 0; i != names.size(); ++i) {
+            rows[i] = names.at(i).second;
+        }
+        break;
+    }
+    case BySize:
+    case ByDuration:
+        std::stable_sort(rows.begin(), rows.end(), [&columns, sortKey](int left, int right) {
+            return isOrderedBefore(columns, sortKey, left, right);
+        });
+        break;
+    case ByArrival:
+        break;
+    }
+
+    return rows;
+}
+
+bool FileListModel::matchesFilter(const Columns& columns, int fileId, const QString& filterText)
+{
+    return filterText.isEmpty()
+        || columns.inputName(fileId).contains(filterText, Qt::CaseInsensitive)
+        || columns.outputName(fileId).contains(filterText, Qt::CaseInsensitive);
+}
+
+bool FileListModel::isOrderedBefore(const Columns& columns, SortKey sortKey, int left, int right)
+{
+    switch (sortKey) {
+    case ByName: {
+        const int order = QString::compare(columns.inputName(left), columns.inputName(right), Qt::CaseInsensitive);
+        if (order != 0) {
+            return order < 0;
+        }
+        break;
+    }
+    case BySize:
+        if (columns.sizes.at(left) != columns.sizes.at(right)) {
+            return columns.sizes.at(left) > columns.sizes.at(right);
+        }
+        break;
+    case ByDuration:
+        if (columns.durationsUs.at(left) != columns.durationsUs.at(right)) {
+            return columns.durationsUs.at(left) > columns.durationsUs.at(right);
+        }
+        break;
+    case ByArrival:
+        break;
+    }
+    return left < right;
+}
+
+QString FileListModel::Columns::inputName(int fileId) const
+{
+    return QString::fromUtf8(names.constData() + nameOffsets.at(fileId), inputNameLengths.at(fileId));
+}
+
+QString FileListModel::Columns::outputName(int fileId) const
+{
+    if (outputNameLengths.at(fileId) == 0) {
+        return inputName(fileId);
+    }
+    return QString::fromUtf8(names.constData() + nameOffsets.at(fileId) + inputNameLengths.at(fileId),
+                             outputNameLengths.at(fileId));
+}
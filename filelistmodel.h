@@ -0,0 +1,109 @@
+#ifndef FILELISTMODEL_H
+#define FILELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QStringList>
+
+class QTimer;
+
+// Processed-file list kept in packed columns rather than one object per row:
+// names live in a single UTF-8 blob, directories are interned, and status,
+// size and duration are stored as plain integers (~30 bytes per file plus
+// the name itself). Appends and status updates are published to views in
+// batches; a new filter or sort order is computed on a pool thread, after
+// which the view is kept current by merging new and re-timed files. Past
+// maxFiles the oldest quarter is dropped, so memory stays bounded on
+// long-running timer sessions; file ids keep counting up regardless.
+class FileListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum Status : quint8 {
+        Pending,
+        Processing,
+        Done,
+        Failed
+    };
+
+    enum SortKey {
+        ByArrival,
+        ByName,
+        BySize,
+        ByDuration
+    };
+
+    explicit FileListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    int addFile(const QString& directory, const QString& inputName,
+                const QString& outputName, qint64 size);
+    void setStatus(int fileId, Status status, qint64 durationUs = 0);
+    void clear();
+
+public slots:
+    void setFilterText(const QString& text);
+    void setSortKey(int sortKey);
+
+private slots:
+    void publishPending();
+    void onViewComputed();
+
+private:
+    struct Columns
+    {
+        QByteArray names;
+        QList<qint64> nameOffsets;
+        QList<quint16> inputNameLengths;
+        QList<quint16> outputNameLengths;
+        QList<quint32> directoryIds;
+        QList<qint64> sizes;
+        QList<quint32> durationsUs;
+        QList<quint8> statuses;
+
+        int count() const { return static_cast<int>(statuses.size()); }
+        QString inputName(int fileId) const;
+        QString outputName(int fileId) const;
+    };
+
+    static const int publishInterval = 100; // ms
+    static const int maxFiles = 100000;
+
+    Columns m_columns;
+    int m_firstFileId = 0;
+    QStringList m_directories;
+    QHash<QString, quint32> m_directoryIds;
+
+    int m_publishedCount = 0;
+    int m_viewComputedCount = 0;
+    int m_firstChangedId = -1;
+    int m_lastChangedId = -1;
+
+    QString m_filterText;
+    SortKey m_sortKey = ByArrival;
+    bool m_hasCustomView = false;
+    bool m_isViewDirty = false;
+    QList<int> m_viewRows;
+    QSet<int> m_movedFileIds; // in the view, but their sort key changed
+    QFutureWatcher<QList<int>> m_viewWatcher;
+    bool m_isViewComputing = false; // until onViewComputed(), not just while the pool thread runs
+
+    QTimer *m_publishTimer;
+
+    int fileIdForRow(int row) const;
+    void dropOldestFiles(int count);
+    void recomputeView();
+    void updateView();
+    void reorderView(const QList<int>& rows);
+    static QList<int> computeView(const Columns& columns, int count,
+                                  const QString& filterText, SortKey sortKey);
+    static bool matchesFilter(const Columns& columns, int fileId, const QString& filterText);
+    static bool isOrderedBefore(const Columns& columns, SortKey sortKey, int left, int right);
+};
+
+#endif // FILELISTMODEL_H
@@ -0,0 +1,46 @@
+#ifndef FILEMETRICS_H
+#define FILEMETRICS_H
+
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <array>
+
+struct FileMetrics
+{
+    enum Phase {
+        Scan,
+        Open,
+        Rename,
+        Read,
+        Xor,
+        Compress,
+        Write,
+        Close,
+        Delete,
+        PhaseCount
+    };
+
+    qint64 bytes = 0;
+    qint64 outputBytes = 0;
+    qint64 queueWaitNs = 0;
+    qint64 processingNs = 0;
+    std::array<qint64, PhaseCount> phaseNs {};
+
+    void addPhase(Phase phase, QElapsedTimer& timer)
+    {
+        phaseNs[phase] += timer.nsecsElapsed();
+        timer.restart();
+    }
+
+    static const char* phaseName(Phase phase)
+    {
+        static const char* const names[PhaseCount] = {
+            "scan", "open", "rename", "read", "xor", "compress", "write", "close", "delete"
+        };
+        return names[phase];
+    }
+};
+
+Q_DECLARE_METATYPE(FileMetrics)
+
+#endif // FILEMETRICS_H
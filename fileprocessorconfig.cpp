@@ -33,6 +33,28 @@ bool FileProcessorConfig::isValid(QString* errorMessage) const
         return false;
     }
 
+    if (m_workerCount < 1) {
+        if (errorMessage) {
+            *errorMessage = "Количество потоков должно быть не меньше 1";
+        }
+        return false;
+    }
+
+    if (m_memoryBudget <= 0) {
+        if (errorMessage) {
+            *errorMessage = "Бюджет памяти должен быть больше нуля";
+        }
+        return false;
+    }
+
+    if (!m_metricsFilePath.isEmpty() && m_metricsInterval < minimumMetricsInterval) {
+        if (errorMessage) {
+            *errorMessage = QString("Интервал записи метрик должен быть не меньше %1 мс")
+                                .arg(minimumMetricsInterval);
+        }
+        return false;
+    }
+
     if (m_fileMasks.isEmpty()) {
         if (errorMessage) {
             *errorMessage = "Укажите маску файлов";
@@ -1,12 +1,17 @@
 #ifndef FILEPROCESSORCONFIG_H
 #define FILEPROCESSORCONFIG_H
 
+#include <QMetaType>
 #include <QString>
 #include <QStringList>
+#include "chunkcodec.h"
+#include "filequeue.h"
 
 class FileProcessorConfig
 {
 public:
+    static constexpr int minimumMetricsInterval = 100; // ms
+
     FileProcessorConfig() = default;
 
     QString inputPath() const { return m_inputPath; }
@@ -17,6 +22,16 @@ public:
     bool isTimerMode() const { return m_isTimerMode; }
     int timerInterval() const { return m_timerInterval; }
     bool addCounterOnConflict() const { return m_addCounterOnConflict; }
+    bool isPackedOutput() const { return m_isPackedOutput; }
+    qint64 segmentSize() const { return m_segmentSize; }
+    CompressionOptions compression() const { return m_compression; }
+    int workerCount() const { return m_workerCount; }
+    SchedulingPolicy schedulingPolicy() const { return m_schedulingPolicy; }
+    qint64 memoryBudget() const { return m_memoryBudget; }
+    QList<int> cpuSet() const { return m_cpuSet; }
+    bool isNumaAware() const { return m_isNumaAware; }
+    QString metricsFilePath() const { return m_metricsFilePath; }
+    int metricsInterval() const { return m_metricsInterval; }
 
     void setInputPath(const QString& path) { m_inputPath = path; }
     void setOutputPath(const QString& path) { m_outputPath = path; }
@@ -26,6 +41,16 @@ public:
     void setTimerMode(bool value) { m_isTimerMode = value; }
     void setTimerInterval(int interval) { m_timerInterval = interval; }
     void setAddCounterOnConflict(bool value) { m_addCounterOnConflict = value; }
+    void setPackedOutput(bool value) { m_isPackedOutput = value; }
+    void setSegmentSize(qint64 size) { m_segmentSize = size; }
+    void setCompression(const CompressionOptions& options) { m_compression = options; }
+    void setWorkerCount(int count) { m_workerCount = count; }
+    void setSchedulingPolicy(SchedulingPolicy policy) { m_schedulingPolicy = policy; }
+    void setMemoryBudget(qint64 bytes) { m_memoryBudget = bytes; }
+    void setCpuSet(const QList<int>& cpus) { m_cpuSet = cpus; }
+    void setNumaAware(bool value) { m_isNumaAware = value; }
+    void setMetricsFilePath(const QString& path) { m_metricsFilePath = path; }
+    void setMetricsInterval(int interval) { m_metricsInterval = interval; }
 
     bool isValid(QString* errorMessage = nullptr) const;
 
@@ -38,6 +63,18 @@ private:
     bool m_isTimerMode = false;
     int m_timerInterval = 5000;
     bool m_addCounterOnConflict = false;
+    bool m_isPackedOutput = false;
+    qint64 m_segmentSize = 1024LL * 1024 * 1024;
+    CompressionOptions m_compression;
+    int m_workerCount = 1;
+    SchedulingPolicy m_schedulingPolicy = SchedulingPolicy::Fifo;
+    qint64 m_memoryBudget = 64LL * 1024 * 1024; // I/O buffers plus the file queue
+    QList<int> m_cpuSet; // empty: workers are not pinned
+    bool m_isNumaAware = false;
+    QString m_metricsFilePath;
+    int m_metricsInterval = 5000;
 };
 
+Q_DECLARE_METATYPE(FileProcessorConfig)
+
 #endif // FILEPROCESSORCONFIG_H
@@ -0,0 +1,85 @@
+#include "filequeue.h"
+
+void FileQueue::setPolicy(SchedulingPolicy policy)
+{
+    if (policy == m_policy) {
+        return;
+    }
+    m_policy = policy;
+
+    std::set<Key> reordered;
+    for (const Key& key : m_order) {
+        const Entry& entry = m_bySequence[key.sequence];
+        reordered.insert({priorityOf(entry.size, entry.enqueueNs), key.sequence});
+    }
+    m_order.swap(reordered);
+}
+
+void FileQueue::push(const QString& filePath, qint64 size, qint64 enqueueNs)
+{
+    if (m_entries.contains(filePath)) {
+        return;
+    }
+
+    const quint64 sequence = m_nextSequence++;
+    m_order.insert({priorityOf(size, enqueueNs), sequence});
+    m_bySequence.insert(sequence, {filePath, size, enqueueNs});
+    m_entries.insert(filePath, sequence);
+}
+
+FileQueue::Entry FileQueue::takeNext(bool isSmallFileLane)
+{
+    if (m_order.empty()) {
+        return Entry();
+    }
+
+    if (m_policy == SchedulingPolicy::LargestFirst && !isSmallFileLane) {
+        // Among equal sizes the earliest arrival still goes first.
+        auto last = std::prev(m_order.end());
+        auto first = m_order.lower_bound({last->priority, 0});
+        return take(first);
+    }
+    return take(m_order.begin());
+}
+
+void FileQueue::clear()
+{
+    m_order.clear();
+    m_bySequence.clear();
+    m_entries.clear();
+}
+
+QString FileQueue::policyName(SchedulingPolicy policy)
+{
+    switch (policy) {
+    case SchedulingPolicy::Fifo: return "fifo";
+    case SchedulingPolicy::ShortestFirst: return "shortest-first";
+    case SchedulingPolicy::LargestFirst: return "largest-first";
+    case SchedulingPolicy::Aging: return "aging";
+    }
+    return QString();
+}
+
+qint64 FileQueue::priorityOf(qint64 size, qint64 enqueueNs) const
+{
+    switch (m_policy) {
+    case SchedulingPolicy::Fifo:
+        return 0;
+    case SchedulingPolicy::ShortestFirst:
+    case SchedulingPolicy::LargestFirst:
+        return size;
+    case SchedulingPolicy::Aging:
+        // size - rate * (now - enqueue) orders the same as size + rate * enqueue.
+        return size + static_cast<qint64>(enqueueNs / 1e9 * agingBytesPerSecond);
+    }
+    return 0;
+}
+
+FileQueue::Entry FileQueue::take(std::set<Key>::iterator it)
+{
+    const quint64 sequence = it->sequence;
+    m_order.erase(it);
+    Entry entry = m_bySequence.take(sequence);
+    m_entries.remove(entry.filePath);
+    return entry;
+}
@@ -0,0 +1,75 @@
+#ifndef FILEQUEUE_H
+#define FILEQUEUE_H
+
+#include <QHash>
+#include <QString>
+
+#include <set>
+
+enum class SchedulingPolicy
+{
+    Fifo,          // order the file system lists the directory in, not sorted by name
+    ShortestFirst, // smallest file first
+    LargestFirst,  // largest file first; the small-file lane takes the smallest
+    Aging          // smallest first, but every second of waiting counts as agingBytesPerSecond less
+};
+
+// Pending files ordered by the scheduling policy. Every policy reduces to a
+// key fixed at enqueue time (aging included, since all entries age at the
+// same rate), so push and take are O(log n). The capacity is advisory: the
+// scanner stops feeding the queue once isFull() (0 means unbounded).
+class FileQueue
+{
+public:
+    struct Entry
+    {
+        QString filePath;
+        qint64 size = 0;
+        qint64 enqueueNs = 0;
+    };
+
+    static constexpr double agingBytesPerSecond = 64.0 * 1024 * 1024;
+
+    explicit FileQueue(SchedulingPolicy policy = SchedulingPolicy::Fifo) : m_policy(policy) {}
+
+    SchedulingPolicy policy() const { return m_policy; }
+    void setPolicy(SchedulingPolicy policy);
+
+    void push(const QString& filePath, qint64 size, qint64 enqueueNs);
+    // isSmallFileLane only matters for LargestFirst, where it takes from the
+    // small end instead.
+    Entry takeNext(bool isSmallFileLane = false);
+
+    bool contains(const QString& filePath) const { return m_entries.contains(filePath); }
+    bool isEmpty() const { return m_order.empty(); }
+    int size() const { return static_cast<int>(m_order.size()); }
+    int capacity() const { return m_capacity; }
+    void setCapacity(int capacity) { m_capacity = capacity; }
+    bool isFull() const { return m_capacity > 0 && size() >= m_capacity; }
+    void clear();
+
+    static QString policyName(SchedulingPolicy policy);
+
+private:
+    struct Key
+    {
+        qint64 priority;
+        quint64 sequence;
+        bool operator<(const Key& other) const
+        {
+            return priority != other.priority ? priority < other.priority : sequence < other.sequence;
+        }
+    };
+
+    SchedulingPolicy m_policy;
+    int m_capacity = 0;
+    quint64 m_nextSequence = 0;
+    std::set<Key> m_order;
+    QHash<quint64, Entry> m_bySequence;
+    QHash<QString, quint64> m_entries;
+
+    qint64 priorityOf(qint64 size, qint64 enqueueNs) const;
+    Entry take(std::set<Key>::iterator it);
+};
+
+#endif // FILEQUEUE_H
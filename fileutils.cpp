@@ -1,7 +1,21 @@
 #include "fileutils.h"
 #include <QDir>
+#include <QFile>
 
-QString FileUtils::generateUniqueFileName(const QString& basePath, const QString& fileName)
+#include <filesystem>
+#include <system_error>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+QString FileUtils::generateUniqueFileName(const QString& basePath, const QString& fileName,
+                                          const QSet<QString>& reservedNames)
 {
     QFileInfo fileInfo(fileName);
     QString baseName = fileInfo.completeBaseName();
@@ -18,7 +32,7 @@ QString FileUtils::generateUniqueFileName(const QString& basePath, const QString
             newFileName = QString("%1 (%2).%3").arg(baseName).arg(counter).arg(suffix);
         }
         counter++;
-    } while (dir.exists(newFileName));
+    } while (dir.exists(newFileName) || reservedNames.contains(newFileName));
 
     return newFileName;
 }
@@ -40,3 +54,107 @@ QString FileUtils::formatFileSize(const QFileInfo& fileInfo)
 {
     return formatFileSize(fileInfo.size());
 }
+
+// Only succeeds when both paths are on the same filesystem; unlike
+// QFile::rename it never falls back to copying the data.
+bool FileUtils::moveFile(const QString& sourcePath, const QString& destinationPath)
+{
+    std::error_code error;
+    std::filesystem::rename(QFileInfo(sourcePath).filesystemFilePath(),
+                            QFileInfo(destinationPath).filesystemFilePath(),
+                            error);
+    return !error;
+}
+
+// Kernel-side copy (reflink, then copy_file_range). Returns false when the
+// filesystem or platform cannot do it, leaving the caller to copy the data itself.
+// A durable clone goes to a temporary file that is synced and renamed into
+// place, then the directory is synced, so the source can be deleted safely.
+bool FileUtils::cloneFile(const QString& sourcePath, const QString& destinationPath, bool isDurable)
+{
+#ifdef Q_OS_LINUX
+    int sourceFd = ::open(QFile::encodeName(sourcePath).constData(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd == -1) {
+        return false;
+    }
+
+    struct stat sourceStat;
+    if (::fstat(sourceFd, &sourceStat) == -1) {
+        ::close(sourceFd);
+        return false;
+    }
+
+    QByteArray writePath = QFile::encodeName(destinationPath);
+    int destinationFd = -1;
+    if (isDurable) {
+        writePath += ".XXXXXX";
+        destinationFd = ::mkostemp(writePath.data(), O_CLOEXEC);
+        if (destinationFd != -1) {
+            ::fchmod(destinationFd, 0644);
+        }
+    } else {
+        destinationFd = ::open(writePath.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    if (destinationFd == -1) {
+        ::close(sourceFd);
+        return false;
+    }
+
+    bool isCloned = false;
+#ifdef FICLONE
+    isCloned = ::ioctl(destinationFd, FICLONE, sourceFd) == 0;
+#endif
+
+    if (!isCloned) {
+        off_t remaining = sourceStat.st_size;
+        while (remaining > 0) {
+            ssize_t copied = ::copy_file_range(sourceFd, nullptr, destinationFd, nullptr,
+                                               static_cast<size_t>(remaining), 0);
+            if (copied <= 0) {
+                break;
+            }
+            remaining -= copied;
+        }
+        isCloned = remaining == 0;
+    }
+
+    if (isCloned && isDurable) {
+        isCloned = ::fsync(destinationFd) == 0;
+    }
+
+    isCloned = ::close(destinationFd) == 0 && isCloned;
+    ::close(sourceFd);
+
+    if (isCloned && isDurable) {
+        isCloned = ::rename(writePath.constData(), QFile::encodeName(destinationPath).constData()) == 0
+            && syncDirectory(QFileInfo(destinationPath).absolutePath());
+    }
+
+    if (!isCloned) {
+        ::unlink(writePath.constData());
+    }
+    return isCloned;
+#else
+    Q_UNUSED(sourcePath);
+    Q_UNUSED(destinationPath);
+    Q_UNUSED(isDurable);
+    return false;
+#endif
+}
+
+// Makes a rename or a newly created file in the directory survive a crash.
+bool FileUtils::syncDirectory(const QString& directoryPath)
+{
+#ifdef Q_OS_LINUX
+    int directoryFd = ::open(QFile::encodeName(directoryPath).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directoryFd == -1) {
+        return false;
+    }
+    const bool isSynced = ::fsync(directoryFd) == 0;
+    ::close(directoryFd);
+    return isSynced;
+#else
+    Q_UNUSED(directoryPath);
+    return true;
+#endif
+}
@@ -3,15 +3,24 @@
 
 #include <QString>
 #include <QFileInfo>
+#include <QSet>
 
 class FileUtils
 {
 public:
-    static QString generateUniqueFileName(const QString& basePath, const QString& fileName);
+    // reservedNames are names already claimed by files still being written.
+    static QString generateUniqueFileName(const QString& basePath, const QString& fileName,
+                                          const QSet<QString>& reservedNames = QSet<QString>());
 
     static QString formatFileSize(qint64 bytes);
 
     static QString formatFileSize(const QFileInfo& fileInfo);
+
+    static bool moveFile(const QString& sourcePath, const QString& destinationPath);
+
+    static bool cloneFile(const QString& sourcePath, const QString& destinationPath, bool isDurable = false);
+
+    static bool syncDirectory(const QString& directoryPath);
 };
 
 #endif // FILEUTILS_H
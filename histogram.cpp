@@ -0,0 +1,51 @@
+#include "histogram.h"
+
+#include <cmath>
+
+void Histogram::reset()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_sum = 0.0;
+}
+
+void Histogram::record(double value)
+{
+    m_buckets[bucketIndex(value)]++;
+    m_count++;
+    m_sum += value;
+}
+
+double Histogram::percentile(double fraction) const
+{
+    if (m_count == 0) {
+        return 0.0;
+    }
+
+    const quint64 rank = static_cast<quint64>(std::ceil(fraction * m_count));
+    quint64 cumulative = 0;
+
+    for (int i = 0; i != bucketCount; ++i) {
+        cumulative += m_buckets[i];
+        if (cumulative >= rank) {
+            return bucketUpperBound(i);
+        }
+    }
+
+    return bucketUpperBound(bucketCount - 1);
+}
+
+int Histogram::bucketIndex(double value)
+{
+    if (value <= minValue) {
+        return 0;
+    }
+
+    int index = static_cast<int>(std::ceil(std::log2(value / minValue) * bucketsPerDoubling));
+    return qBound(0, index, bucketCount - 1);
+}
+
+double Histogram::bucketUpperBound(int index)
+{
+    return minValue * std::exp2(static_cast<double>(index) / bucketsPerDoubling);
+}
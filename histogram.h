@@ -0,0 +1,34 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <QtGlobal>
+#include <array>
+
+// Log-bucketed histogram of positive values: each bucket is 2^(1/4) wider than
+// the previous one, so percentiles are accurate to within ~10%.
+class Histogram
+{
+public:
+    Histogram() = default;
+
+    void reset();
+    void record(double value);
+
+    quint64 count() const { return m_count; }
+    double sum() const { return m_sum; }
+    double percentile(double fraction) const;
+
+private:
+    static constexpr double minValue = 1e-6;
+    static constexpr int bucketsPerDoubling = 4;
+    static constexpr int bucketCount = 160;
+
+    std::array<quint64, bucketCount> m_buckets {};
+    quint64 m_count = 0;
+    double m_sum = 0.0;
+
+    static int bucketIndex(double value);
+    static double bucketUpperBound(int index);
+};
+
+#endif // HISTOGRAM_H
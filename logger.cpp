@@ -0,0 +1,177 @@
+#include "logger.h"
+
+#include <QDateTime>
+#include <QTimer>
+
+namespace {
+
+const std::size_t queueCapacity = 64 * 1024;
+
+const char* levelPrefix(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::Warning:
+        return "WARN ";
+    case LogLevel::Error:
+        return "ERROR ";
+    default:
+        return "";
+    }
+}
+
+} // namespace
+
+Logger::Logger(QObject *parent)
+    : QObject{parent}
+    , m_queue(queueCapacity)
+{}
+
+void Logger::log(LogLevel level, const QString& message)
+{
+    if (!isEnabled(level)) {
+        return;
+    }
+
+    Entry entry;
+    entry.timestamp = QDateTime::currentMSecsSinceEpoch();
+    entry.level = level;
+    entry.generation = m_generation.load(std::memory_order_relaxed);
+    entry.message = message;
+
+    if (!m_queue.tryPush(std::move(entry))) {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Logger::setFileSink(const QString& filePath, qint64 maxFileSize, int maxFiles)
+{
+    QMetaObject::invokeMethod(this, [this, filePath, maxFileSize, maxFiles]() {
+        openFileSink(filePath, maxFileSize, maxFiles);
+    });
+}
+
+bool Logger::parseLevel(const QString& text, LogLevel* level)
+{
+    static const QStringList names = { "debug", "info", "warning", "error" };
+    int index = names.indexOf(text.trimmed().toLower());
+    if (index == -1) {
+        return false;
+    }
+
+    *level = static_cast<LogLevel>(index);
+    return true;
+}
+
+void Logger::start()
+{
+    if (!m_drainTimer) {
+        m_drainTimer = new QTimer(this);
+        connect(m_drainTimer, &QTimer::timeout, this, &Logger::drain);
+    }
+    m_drainTimer->start(drainInterval);
+}
+
+void Logger::stop()
+{
+    if (m_drainTimer) {
+        m_drainTimer->stop();
+    }
+    drain();
+    m_file.close();
+}
+
+void Logger::drain()
+{
+    QStringList lines;
+    quint64 generation = 0;
+    Entry entry;
+
+    // Entries come out in logging order, so a batch is cut wherever the
+    // generation changes.
+    while (m_queue.tryPop(entry)) {
+        if (!lines.isEmpty() && entry.generation != generation) {
+            writeLines(lines, generation);
+            lines.clear();
+        }
+        generation = entry.generation;
+        lines.append(formatEntry(entry));
+    }
+
+    const quint64 droppedCount = m_droppedCount.exchange(0, std::memory_order_relaxed);
+    if (droppedCount != 0) {
+        const quint64 currentGeneration = m_generation.load(std::memory_order_relaxed);
+        if (!lines.isEmpty() && generation != currentGeneration) {
+            writeLines(lines, generation);
+            lines.clear();
+        }
+        generation = currentGeneration;
+
+        Entry dropped;
+        dropped.timestamp = QDateTime::currentMSecsSinceEpoch();
+        dropped.level = LogLevel::Warning;
+        dropped.message = QString("log queue overflow: %1 message(s) dropped").arg(droppedCount);
+        lines.append(formatEntry(dropped));
+    }
+
+    if (!lines.isEmpty()) {
+        writeLines(lines, generation);
+    }
+}
+
+void Logger::writeLines(const QStringList& lines, quint64 generation)
+{
+    if (m_file.isOpen()) {
+        for (const QString& line : lines) {
+            m_file.write(line.toUtf8());
+            m_file.write("\n");
+        }
+        m_file.flush();
+
+        if (m_maxFileSize > 0 && m_file.size() >= m_maxFileSize) {
+            rotateFileSink();
+        }
+    }
+
+    emit messagesReady(lines, generation);
+}
+
+void Logger::openFileSink(const QString& filePath, qint64 maxFileSize, int maxFiles)
+{
+    m_file.close();
+    m_maxFileSize = maxFileSize;
+    m_maxFiles = maxFiles;
+
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        log(LogLevel::Error, "Не удалось открыть файл журнала: " + filePath);
+    }
+}
+
+void Logger::rotateFileSink()
+{
+    const QString filePath = m_file.fileName();
+    m_file.close();
+
+    QFile::remove(filePath + "." + QString::number(m_maxFiles));
+    for (int i = m_maxFiles - 1; i >= 1; --i) {
+        QFile::rename(filePath + "." + QString::number(i), filePath + "." + QString::number(i + 1));
+    }
+
+    if (m_maxFiles > 0) {
+        QFile::rename(filePath, filePath + ".1");
+    } else {
+        QFile::remove(filePath);
+    }
+
+    m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+}
+
+QString Logger::formatEntry(const Entry& entry)
+{
+    QString timestamp = QDateTime::fromMSecsSinceEpoch(entry.timestamp).toString("hh:mm:ss");
+    return "[" + timestamp + "] " + levelPrefix(entry.level) + entry.message;
+}
@@ -0,0 +1,81 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QObject>
+#include <QFile>
+#include <QStringList>
+#include <atomic>
+#include "ringbuffer.h"
+
+class QTimer;
+
+enum class LogLevel
+{
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+// Asynchronous log backend. log() is safe to call from any thread and never
+// blocks: entries go into a bounded ring buffer and are dropped (and counted)
+// when it is full. The logger's own thread drains the buffer periodically,
+// feeds the optional rotating file sink and hands batches to the UI. Each
+// batch carries the generation its entries were logged in, so a view that
+// was cleared by startGeneration() can skip lines from earlier runs.
+class Logger : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Logger(QObject *parent = nullptr);
+
+    void log(LogLevel level, const QString& message);
+
+    void setMinimumLevel(LogLevel level) { m_minimumLevel.store(level, std::memory_order_relaxed); }
+    LogLevel minimumLevel() const { return m_minimumLevel.load(std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const { return level >= minimumLevel(); }
+
+    void setFileSink(const QString& filePath, qint64 maxFileSize, int maxFiles);
+
+    quint64 startGeneration() { return m_generation.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+    static bool parseLevel(const QString& text, LogLevel* level);
+
+public slots:
+    void start();
+    void stop();
+
+signals:
+    void messagesReady(const QStringList& lines, quint64 generation);
+
+private slots:
+    void drain();
+
+private:
+    struct Entry
+    {
+        qint64 timestamp = 0;
+        LogLevel level = LogLevel::Info;
+        quint64 generation = 0;
+        QString message;
+    };
+
+    static const int drainInterval = 50; // ms
+
+    RingBuffer<Entry> m_queue;
+    std::atomic<LogLevel> m_minimumLevel { LogLevel::Debug };
+    std::atomic<quint64> m_droppedCount { 0 };
+    std::atomic<quint64> m_generation { 0 };
+
+    QTimer *m_drainTimer = nullptr;
+    QFile m_file;
+    qint64 m_maxFileSize = 0;
+    int m_maxFiles = 0;
+
+    void openFileSink(const QString& filePath, qint64 maxFileSize, int maxFiles);
+    void rotateFileSink();
+    void writeLines(const QStringList& lines, quint64 generation);
+    static QString formatEntry(const Entry& entry);
+};
+
+#endif // LOGGER_H
@@ -0,0 +1,48 @@
+#include "logmodel.h"
+
+LogModel::LogModel(int maxLines, QObject *parent)
+    : QAbstractListModel{parent}
+    , m_maxLines(maxLines)
+{}
+
+int LogModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_lines.size());
+}
+
+QVariant LogModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_lines.size() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    return m_lines.at(index.row());
+}
+
+void LogModel::appendLines(const QStringList& lines, quint64 generation)
+{
+    if (lines.isEmpty() || generation < m_generation) {
+        return;
+    }
+
+    const qsizetype incoming = qMin<qsizetype>(lines.size(), m_maxLines);
+    const qsizetype overflow = m_lines.size() + incoming - m_maxLines;
+
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(overflow - 1));
+        m_lines.remove(0, overflow);
+        endRemoveRows();
+    }
+
+    const int first = static_cast<int>(m_lines.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(incoming) - 1);
+    m_lines.append(lines.mid(lines.size() - incoming));
+    endInsertRows();
+}
+
+void LogModel::clear(quint64 generation)
+{
+    m_generation = generation;
+    beginResetModel();
+    m_lines.clear();
+    endResetModel();
+}
@@ -0,0 +1,29 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+
+// Keeps only the most recent lines so the log view stays cheap to render
+// however long the run is. Batches from a generation older than the one
+// passed to the last clear() are ignored.
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    explicit LogModel(int maxLines, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+public slots:
+    void appendLines(const QStringList& lines, quint64 generation);
+    void clear(quint64 generation);
+
+private:
+    int m_maxLines;
+    QStringList m_lines;
+    quint64 m_generation = 0;
+};
+
+#endif // LOGMODEL_H
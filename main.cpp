@@ -1,11 +1,114 @@
 #include "mainwindow.h"
+#include "commandlinetools.h"
+#include "cputopology.h"
+#include "fileprocessorconfig.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <cstring>
+
+static bool hasArgument(int argc, char *argv[], const char *name)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
 
 int main(int argc, char *argv[])
 {
+    if (hasArgument(argc, argv, "--extract")) {
+        QCoreApplication app(argc, argv);
+        return runSegmentExtractor(app.arguments());
+    }
+
+    if (hasArgument(argc, argv, "--decode")) {
+        QCoreApplication app(argc, argv);
+        return runStreamDecoder(app.arguments());
+    }
+
+    if (hasArgument(argc, argv, "--pipe")) {
+        QCoreApplication app(argc, argv);
+        return runPipeMode(app.arguments());
+    }
+
     QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption metricsFileOption("metrics-file",
+                                         "Periodically write Prometheus text metrics to <file>.",
+                                         "file");
+    QCommandLineOption metricsIntervalOption("metrics-interval",
+                                             "Metrics file refresh interval in ms (at least 100).",
+                                             "ms", "5000");
+    QCommandLineOption logLevelOption("log-level",
+                                      "Minimum log level: debug, info, warning or error.",
+                                      "level", "debug");
+    QCommandLineOption logFileOption("log-file",
+                                     "Also write the log to <file>.",
+                                     "file");
+    QCommandLineOption logFileSizeOption("log-file-size",
+                                         "Rotate the log file after <mb> megabytes.",
+                                         "mb", "10");
+    QCommandLineOption logFileCountOption("log-file-count",
+                                          "Number of rotated log files to keep.",
+                                          "count", "5");
+    QCommandLineOption memoryBudgetOption("memory-budget",
+                                          "Memory for I/O buffers and the file queue, in megabytes.",
+                                          "mb", "64");
+    QCommandLineOption cpuSetOption("cpu-set",
+                                    "Pin worker threads to these CPUs, e.g. 0-7,16-23.",
+                                    "cpus");
+    QCommandLineOption numaOption("numa",
+                                  "Spread workers over NUMA nodes with node-local buffers.");
+    parser.addOption(metricsFileOption);
+    parser.addOption(metricsIntervalOption);
+    parser.addOption(logLevelOption);
+    parser.addOption(logFileOption);
+    parser.addOption(logFileSizeOption);
+    parser.addOption(logFileCountOption);
+    parser.addOption(memoryBudgetOption);
+    parser.addOption(cpuSetOption);
+    parser.addOption(numaOption);
+    parser.process(a);
+
+    bool isIntervalValid = false;
+    int metricsInterval = parser.value(metricsIntervalOption).toInt(&isIntervalValid);
+    if (!isIntervalValid || metricsInterval <= 0) {
+        qCritical("Invalid metrics interval: %s", qPrintable(parser.value(metricsIntervalOption)));
+        return 1;
+    }
+    if (metricsInterval < FileProcessorConfig::minimumMetricsInterval) {
+        qWarning("Metrics interval raised to the minimum of %d ms",
+                 FileProcessorConfig::minimumMetricsInterval);
+        metricsInterval = FileProcessorConfig::minimumMetricsInterval;
+    }
+
     MainWindow w;
+    w.setMetricsFile(parser.value(metricsFileOption), metricsInterval);
+    w.setMemoryBudget(parser.value(memoryBudgetOption).toLongLong() * 1024 * 1024);
+
+    QList<int> cpuSet;
+    if (!CpuTopology::parseCpuList(parser.value(cpuSetOption), &cpuSet)) {
+        qWarning("Invalid CPU list: %s", qPrintable(parser.value(cpuSetOption)));
+        cpuSet.clear();
+    }
+    w.setWorkerPlacement(cpuSet, parser.isSet(numaOption));
+
+    LogLevel logLevel = LogLevel::Debug;
+    if (!Logger::parseLevel(parser.value(logLevelOption), &logLevel)) {
+        qWarning("Unknown log level: %s", qPrintable(parser.value(logLevelOption)));
+    }
+    w.logger()->setMinimumLevel(logLevel);
+
+    if (parser.isSet(logFileOption)) {
+        w.logger()->setFileSink(parser.value(logFileOption),
+                                parser.value(logFileSizeOption).toLongLong() * 1024 * 1024,
+                                parser.value(logFileCountOption).toInt());
+    }
     w.show();
     return a.exec();
 }
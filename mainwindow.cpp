@@ -1,11 +1,12 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
-#include "fileutils.h"
+#include "logmodel.h"
+#include "filelistmodel.h"
+#include "processingcontroller.h"
 
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QRegularExpressionValidator>
-#include <QDateTime>
 #include <QDebug>
 #include <QResizeEvent>
 #include <QScreen>
@@ -15,7 +16,6 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , m_isProcessing(false)
-    , m_isWorkerBusy(false)
 {
     ui->setupUi(this);
     
@@ -31,9 +31,16 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
-    if (m_workerThread->isRunning()) {
-        m_workerThread->quit();
-        m_workerThread->wait(3000);
+    if (m_controllerThread->isRunning()) {
+        QMetaObject::invokeMethod(m_controller, &ProcessingController::shutdown, Qt::BlockingQueuedConnection);
+        m_controllerThread->quit();
+        m_controllerThread->wait(3000);
+    }
+
+    if (m_loggerThread->isRunning()) {
+        QMetaObject::invokeMethod(m_logger, &Logger::stop, Qt::BlockingQueuedConnection);
+        m_loggerThread->quit();
+        m_loggerThread->wait(3000);
     }
 
     delete ui;
@@ -55,19 +62,39 @@ void MainWindow::setupUI()
 
 void MainWindow::setupConnections()
 {
-    m_processingTimer = new QTimer(this);
-    connect(m_processingTimer, &QTimer::timeout, this, &MainWindow::onProcessingTimerTimeout);
+    m_logModel = new LogModel(maxLogLines, this);
+    ui->viewLogs->setModel(m_logModel);
+
+    m_loggerThread = new QThread(this);
+    m_logger = new Logger();
+    m_logger->moveToThread(m_loggerThread);
+
+    connect(m_loggerThread, &QThread::started, m_logger, &Logger::start);
+    connect(m_loggerThread, &QThread::finished, m_logger, &QObject::deleteLater);
+    connect(m_logger, &Logger::messagesReady, m_logModel, &LogModel::appendLines);
+    connect(m_logger, &Logger::messagesReady, ui->viewLogs, &QListView::scrollToBottom);
+
+    m_loggerThread->start();
 
-    m_workerThread = new QThread(this);
-    m_worker = new Worker();
-    m_worker->moveToThread(m_workerThread);
+    m_fileListModel = new FileListModel(this);
+    ui->viewFiles->setModel(m_fileListModel);
 
-    connect(m_worker, &Worker::errorOccurred, this, &MainWindow::onWorkerErrorOccurred);
-    connect(m_worker, &Worker::progressChanged, this, &MainWindow::onWorkerProgressChanged);
-    connect(m_worker, &Worker::finished, this, &MainWindow::onWorkerFinished);
-    connect(m_worker, &Worker::statusChanged, this, &MainWindow::onWorkerStatusChanged);
+    connect(ui->EditFilesFilter, &QLineEdit::textChanged, m_fileListModel, &FileListModel::setFilterText);
+    connect(ui->FilesSort, &QComboBox::currentIndexChanged, m_fileListModel, &FileListModel::setSortKey);
+    connect(m_fileListModel, &FileListModel::rowsInserted, ui->viewFiles, &QListView::scrollToBottom);
 
-    m_workerThread->start();
+    qRegisterMetaType<FileProcessorConfig>();
+    qRegisterMetaType<ProcessingSnapshot>();
+
+    m_controllerThread = new QThread(this);
+    m_controller = new ProcessingController(m_logger);
+    m_controller->moveToThread(m_controllerThread);
+
+    connect(m_controllerThread, &QThread::finished, m_controller, &QObject::deleteLater);
+    connect(m_controller, &ProcessingController::snapshotReady, this, &MainWindow::onSnapshotReady);
+    connect(m_controller, &ProcessingController::processingStopped, this, &MainWindow::onProcessingStopped);
+
+    m_controllerThread->start();
 }
 
 void MainWindow::setupValidator()
@@ -140,9 +167,24 @@ FileProcessorConfig MainWindow::getConfigFromUI() const
     config.setFileMasks(ui->EditFileMask->text().split(',', Qt::SkipEmptyParts));
     config.setXorKey(QByteArray::fromHex(ui->EditXOR->text().toUtf8()));
     config.setDeleteInputFiles(ui->checkBoxDeleteInput->isChecked());
+    config.setPackedOutput(ui->checkBoxPackedOutput->isChecked());
+
+    CompressionOptions compression;
+    compression.level = ui->checkBoxCompress->isChecked() ? ui->CompressionLevel->value() : 0;
+    compression.order = ui->CompressionOrder->currentIndex() == 0
+        ? CompressionOptions::CompressThenXor
+        : CompressionOptions::XorThenCompress;
+    config.setCompression(compression);
+    config.setWorkerCount(ui->WorkerCount->value());
+    config.setSchedulingPolicy(static_cast<SchedulingPolicy>(ui->SchedulingPolicy->currentIndex()));
     config.setTimerMode(ui->WorkMode->currentText() == "Работа по таймеру");
     config.setTimerInterval(ui->Interval->value());
     config.setAddCounterOnConflict(ui->ActionOnConflict->currentText() == "Добавить Счётчик");
+    config.setMetricsFilePath(m_metricsFilePath);
+    config.setMetricsInterval(m_metricsInterval);
+    config.setMemoryBudget(m_memoryBudget);
+    config.setCpuSet(m_cpuSet);
+    config.setNumaAware(m_isNumaAware);
     return config;
 }
 
@@ -177,86 +219,24 @@ void MainWindow::startProcessing() {
     toggleUI(true);
 
     ui->progressBar->setValue(0);
-    m_processedFiles.clear();
-    m_fileQueue.clear();
-    m_statistics.reset();
+    m_errors.clear();
+    ui->statusbar->clearMessage();
 
-    ui->editLogs->clear();
-    ui->filesWidget->clear();
+    // Lines still queued from the previous run belong to the old generation
+    // and are dropped by the model when they arrive.
+    m_logModel->clear(m_logger->startGeneration());
+    m_fileListModel->clear();
 
-    FileProcessorConfig config = getConfigFromUI();
-    
-    logMessage("=== START ===");
-    logMessage("input path: " + config.inputPath());
-    logMessage("output path: " + config.outputPath());
-    logMessage("file mask: " + ui->EditFileMask->text());
-    logMessage("XOR key: " + ui->EditXOR->text());
-
-    if (config.isTimerMode()) {
-        int interval = config.timerInterval();
-        m_processingTimer->start(interval);
-        logMessage("Interval Mode: timer = " + QString::number(interval) + " ms");
-    } else {
-        logMessage("One time Mode");
-        scanForFiles();
-    }
+    QMetaObject::invokeMethod(m_controller, "start", Qt::QueuedConnection,
+                              Q_ARG(FileProcessorConfig, getConfigFromUI()),
+                              Q_ARG(int, ++m_runId));
 }
 
 void MainWindow::stopProcessing() {
     m_isProcessing = false;
     toggleUI(false);
-    m_processingTimer->stop();
-
-    logStatistics();
-}
 
-void MainWindow::onProcessingTimerTimeout() {
-    scanForFiles();
-}
-
-void MainWindow::scanForFiles() {
-    if (!m_isProcessing) return;
-
-    FileProcessorConfig config = getConfigFromUI();
-    QDir directory(config.inputPath());
-
-    if (!directory.exists()) {
-        logMessage("error: input directory doesnt exist");
-        stopProcessing();
-        return;
-    }
-
-    if (config.isTimerMode()) {
-        m_processedFiles.clear();
-    }
-
-    QStringList filesToProcess;
-    
-    for (const QString& mask : config.fileMasks()) {
-        QString cleanMask = mask.trimmed();
-        QStringList files = directory.entryList(QStringList() << cleanMask, QDir::Files | QDir::NoDotAndDotDot);
-        for (const QString& file : files) {
-            QString filePath = directory.absoluteFilePath(file);
-            if (shouldProcessFile(filePath)) {
-                filesToProcess.append(filePath);
-            }
-        }
-    }
-
-    if (!filesToProcess.isEmpty()) {
-        m_fileQueue.append(filesToProcess);
-        logMessage("Found " + QString::number(filesToProcess.size()) + " file(s) to process");
-
-        if (!m_isWorkerBusy) {
-            processNextFile();
-        }
-    } else if (!config.isTimerMode()) {
-        logMessage("Files with current masks not found");
-        if (m_processedFiles.isEmpty()) {
-            QMessageBox::information(this, "Информация", "Файлы по заданной маске не найдены");
-        }
-        stopProcessing();
-    }
+    QMetaObject::invokeMethod(m_controller, "stop", Qt::QueuedConnection);
 }
 
 void MainWindow::toggleUI(bool processing) {
@@ -271,157 +251,80 @@ void MainWindow::toggleUI(bool processing) {
     ui->WorkMode->setEnabled(!processing);
     ui->ActionOnConflict->setEnabled(!processing);
     ui->checkBoxDeleteInput->setEnabled(!processing);
+    ui->checkBoxPackedOutput->setEnabled(!processing);
+    ui->checkBoxCompress->setEnabled(!processing);
+    ui->CompressionLevel->setEnabled(!processing);
+    ui->CompressionOrder->setEnabled(!processing);
+    ui->WorkerCount->setEnabled(!processing);
+    ui->SchedulingPolicy->setEnabled(!processing);
     ui->Interval->setEnabled(!processing &&
                                         ui->WorkMode->currentText() == "Работа по таймеру");
 }
 
-bool MainWindow::shouldProcessFile(const QString& filePath) {
-    if (!m_currentInputFile.isEmpty() && m_currentInputFile == filePath) {
-        return false;
+void MainWindow::onSnapshotReady(const ProcessingSnapshot& snapshot) {
+    if (snapshot.runId != m_runId) {
+        return;
     }
 
-    if (m_processedFiles.contains(filePath)) {
-        return false;
-    }
-    
-    if (m_fileQueue.contains(filePath)) {
-        return false;
+    ui->progressBar->setValue(snapshot.progress);
+    if (!snapshot.status.isEmpty()) {
+        ui->labelStatus->setText(snapshot.status);
     }
 
-    QFileInfo fileInfo(filePath);
-    return fileInfo.isReadable();
-}
-
-void MainWindow::processNextFile() {
-    if (m_fileQueue.isEmpty() || m_isWorkerBusy) {
-        return;
+    for (const ProcessingSnapshot::StartedFile& file : snapshot.startedFiles) {
+        m_fileListModel->addFile(file.directory, file.inputName, file.outputName, file.size);
     }
-    
-    QString filePath = m_fileQueue.takeFirst();
-    m_currentInputFile = filePath;
-    m_isWorkerBusy = true;
 
-    QFileInfo fileInfo(filePath);
-    FileProcessorConfig config = getConfigFromUI();
-    
-    QString outputFileName = fileInfo.fileName();
-    QString fullOutputPath = QDir(config.outputPath()).absoluteFilePath(outputFileName);
-
-    if (config.addCounterOnConflict() && QFile::exists(fullOutputPath)) {
-        outputFileName = FileUtils::generateUniqueFileName(config.outputPath(), outputFileName);
-        fullOutputPath = QDir(config.outputPath()).absoluteFilePath(outputFileName);
+    for (const ProcessingSnapshot::CompletedFile& file : snapshot.completedFiles) {
+        m_fileListModel->setStatus(file.fileId,
+                                   file.success ? FileListModel::Done : FileListModel::Failed,
+                                   file.durationUs);
     }
 
-    logFileProcessingStart(fileInfo, outputFileName);
-    updateFileList(fileInfo.fileName(), outputFileName);
-
-    QMetaObject::invokeMethod(m_worker, "processFile",
-                              Qt::QueuedConnection,
-                              Q_ARG(QString, filePath),
-                              Q_ARG(QString, fullOutputPath),
-                              Q_ARG(QByteArray, config.xorKey())
-                              );
-}
+    if (!snapshot.errors.isEmpty()) {
+        m_errors.append(snapshot.errors);
+        if (m_errors.size() > maxErrors) {
+            m_errors.remove(0, m_errors.size() - maxErrors);
+        }
 
-void MainWindow::processSingleFile(const QString &filePath)
-{
-    m_fileQueue.append(filePath);
-    if (!m_isWorkerBusy) {
-        processNextFile();
+        ui->statusbar->showMessage(QString("Ошибок: %1. Последняя: %2")
+                                       .arg(snapshot.errorCount)
+                                       .arg(m_errors.last()));
+        ui->statusbar->setToolTip(m_errors.mid(qMax<qsizetype>(0, m_errors.size() - 20)).join('\n'));
     }
 }
 
-void MainWindow::updateFileList(const QString& inputFile, const QString& outputFile) {
-    QString itemText = inputFile + " -> " + outputFile;
-    ui->filesWidget->addItem(itemText);
-    ui->filesWidget->scrollToBottom();
-}
-
-void MainWindow::onWorkerProgressChanged(int percent) {
-    ui->progressBar->setValue(percent);
-}
-
-void MainWindow::onWorkerStatusChanged(const QString& status) {
-    ui->labelStatus->setText(status);
-}
-
-void MainWindow::onWorkerFinished() {
-    m_isWorkerBusy = false;
-    
-    if (!m_currentInputFile.isEmpty()) {
-        m_processedFiles.append(m_currentInputFile);
-        
-        QFileInfo fileInfo(m_currentInputFile);
-        m_statistics.addSuccess(fileInfo.size());
-        
-        logFileProcessingSuccess(fileInfo);
-        
-        FileProcessorConfig config = getConfigFromUI();
-        if (config.deleteInputFiles()) {
-            if (QFile::remove(m_currentInputFile)) {
-                logMessage("Входной файл удален: " + m_currentInputFile);
-            } else {
-                logMessage("Ошибка удаления входного файла: " + m_currentInputFile);
-            }
-        }
-        
-        m_currentInputFile.clear();
+void MainWindow::onProcessingStopped(int runId, bool noFilesFound) {
+    if (runId != m_runId) {
+        return;
     }
 
-    if (!m_fileQueue.isEmpty() && m_isProcessing) {
-        processNextFile();
-    } else if (m_fileQueue.isEmpty()) {
-        FileProcessorConfig config = getConfigFromUI();
-        if (!config.isTimerMode() && m_isProcessing) {
-            stopProcessing();
-        }
+    if (m_isProcessing) {
+        m_isProcessing = false;
+        toggleUI(false);
     }
-}
-
-void MainWindow::onWorkerErrorOccurred(const QString& errorMessage) {
-    m_statistics.addError();
-    logFileProcessingError(errorMessage);
-    
-    QMessageBox::warning(this, "Ошибка", errorMessage);
-    
-    m_isWorkerBusy = false;
-    m_currentInputFile.clear();
 
-    if (!m_fileQueue.isEmpty() && m_isProcessing) {
-        processNextFile();
+    if (noFilesFound) {
+        QMessageBox::information(this, "Информация", "Файлы по заданной маске не найдены");
     }
 }
 
-void MainWindow::logMessage(const QString& message) {
-    QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
-    ui->editLogs->append("[" + timestamp + "] " + message);
-    ui->editLogs->ensureCursorVisible();
+void MainWindow::setMetricsFile(const QString& filePath, int interval) {
+    m_metricsFilePath = filePath;
+    m_metricsInterval = interval;
 }
 
-void MainWindow::logFileProcessingStart(const QFileInfo& fileInfo, const QString& outputFileName) {
-    QString sizeStr = FileUtils::formatFileSize(fileInfo);
-    logMessage(">>> Начата обработка: " + fileInfo.fileName() + " (" + sizeStr + ") -> " + outputFileName);
+void MainWindow::setMemoryBudget(qint64 bytes) {
+    m_memoryBudget = bytes;
 }
 
-void MainWindow::logFileProcessingSuccess(const QFileInfo& fileInfo) {
-    QString sizeStr = FileUtils::formatFileSize(fileInfo);
-    logMessage("<<< Успешно обработан: " + fileInfo.fileName() + " (" + sizeStr + ")");
-}
-
-void MainWindow::logFileProcessingError(const QString& errorMessage) {
-    logMessage("!!! Ошибка обработки: " + errorMessage);
-    
-    if (!m_currentInputFile.isEmpty()) {
-        logMessage("!!! Файл с ошибкой: " + QFileInfo(m_currentInputFile).fileName());
-    }
+void MainWindow::setWorkerPlacement(const QList<int>& cpuSet, bool isNumaAware) {
+    m_cpuSet = cpuSet;
+    m_isNumaAware = isNumaAware;
 }
 
-void MainWindow::logStatistics() {
-    logMessage("=== STOP ===");
-    logMessage("processed files count: " + QString::number(m_processedFiles.size()));
-    logMessage("Успешно обработано: " + QString::number(m_statistics.successCount()) + " файлов");
-    logMessage("Ошибок обработки: " + QString::number(m_statistics.errorCount()) + " файлов");
-    logMessage("Всего обработано данных: " + m_statistics.getFormattedSize());
+void MainWindow::logMessage(const QString& message, LogLevel level) {
+    m_logger->log(level, message);
 }
 
 void MainWindow::resizeEvent(QResizeEvent *event)
@@ -2,14 +2,16 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QTimer>
 #include <QThread>
 #include <QDir>
 #include <QFileInfo>
-#include <QListWidgetItem>
-#include "worker.h"
 #include "fileprocessorconfig.h"
-#include "processingstatistics.h"
+#include "processingsnapshot.h"
+#include "logger.h"
+
+class LogModel;
+class FileListModel;
+class ProcessingController;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -25,32 +27,41 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    void setMetricsFile(const QString& filePath, int interval);
+    void setMemoryBudget(qint64 bytes);
+    void setWorkerPlacement(const QList<int>& cpuSet, bool isNumaAware);
+    Logger* logger() const { return m_logger; }
+
 private slots:
     void on_buttonStartStop_clicked();
     void on_buttonBrowseInput_clicked();
     void on_buttonBrowseOutput_clicked();
     void on_WorkMode_currentTextChanged(const QString &text);
 
-    void onWorkerProgressChanged(int percent);
-    void onWorkerStatusChanged(const QString &status);
-    void onWorkerFinished();
-    void onWorkerErrorOccurred(const QString &errorMessage);
-    void onProcessingTimerTimeout();
+    void onSnapshotReady(const ProcessingSnapshot &snapshot);
+    void onProcessingStopped(int runId, bool noFilesFound);
 
 private:
     Ui::MainWindow *ui;
     
-    QTimer *m_processingTimer;
-    Worker *m_worker;
-    QThread *m_workerThread;
-    
+    Logger *m_logger;
+    QThread *m_loggerThread;
+    LogModel *m_logModel;
+    FileListModel *m_fileListModel;
+    ProcessingController *m_controller;
+    QThread *m_controllerThread;
+
+    static const int maxLogLines = 10000;
+    static const int maxErrors = 1000;
+
     bool m_isProcessing;
-    bool m_isWorkerBusy;
-    QString m_currentInputFile;
-    QStringList m_processedFiles;
-    QStringList m_fileQueue;
-    
-    ProcessingStatistics m_statistics;
+    int m_runId = 0;
+    QStringList m_errors;
+    QString m_metricsFilePath;
+    int m_metricsInterval = 5000;
+    qint64 m_memoryBudget = FileProcessorConfig().memoryBudget();
+    QList<int> m_cpuSet;
+    bool m_isNumaAware = false;
 
     void setupUI();
     void setupConnections();
@@ -63,17 +74,7 @@ private:
     void stopProcessing();
     void toggleUI(bool processing);
     
-    void scanForFiles();
-    void processNextFile();
-    void processSingleFile(const QString& filePath);
-    bool shouldProcessFile(const QString& filePath);
-    
-    void logMessage(const QString& message);
-    void logFileProcessingStart(const QFileInfo& fileInfo, const QString& outputFileName);
-    void logFileProcessingSuccess(const QFileInfo& fileInfo);
-    void logFileProcessingError(const QString& errorMessage);
-    void logStatistics();
-    void updateFileList(const QString& inputFile, const QString& outputFile);
+    void logMessage(const QString& message, LogLevel level = LogLevel::Info);
     
     void adjustUIForResolution();
     void applyDPIScaling();
@@ -0,0 +1,690 @@
+#include "processingcontroller.h"
+#include "fileutils.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QThread>
+#include <QTimer>
+
+#include <limits>
+
+namespace {
+
+QList<int> intersectCpus(const QList<int>& cpus, const QList<int>& allowed)
+{
+    if (allowed.isEmpty()) {
+        return cpus;
+    }
+
+    QList<int> result;
+    for (int cpu : cpus) {
+        if (allowed.contains(cpu)) {
+            result.append(cpu);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+ProcessingController::ProcessingController(Logger *logger, QObject *parent)
+    : QObject{parent}
+    , m_logger(logger)
+{
+    qRegisterMetaType<FileMetrics>();
+    qRegisterMetaType<CompressionOptions>();
+
+    m_processingTimer = new QTimer(this);
+    connect(m_processingTimer, &QTimer::timeout, this, &ProcessingController::scanForFiles);
+
+    m_metricsTimer = new QTimer(this);
+    connect(m_metricsTimer, &QTimer::timeout, this, &ProcessingController::writeMetricsFile);
+
+    m_snapshotTimer = new QTimer(this);
+    m_snapshotTimer->setSingleShot(true);
+    m_snapshotTimer->setInterval(snapshotInterval);
+    connect(m_snapshotTimer, &QTimer::timeout, this, &ProcessingController::publishSnapshot);
+
+    m_bufferPools.push_back(std::make_unique<BufferPool>(workerBufferSize, workerBufferSize));
+    if (CpuTopology::isNuma()) {
+        for (const CpuTopology::Node& node : CpuTopology::nodes()) {
+            m_bufferPools.push_back(std::make_unique<BufferPool>(workerBufferSize, workerBufferSize, node.id));
+        }
+    }
+
+    ensureWorkers(1);
+    m_queueClock.start();
+}
+
+ProcessingController::~ProcessingController() = default;
+
+void ProcessingController::start(const FileProcessorConfig& config, int runId)
+{
+    m_config = config;
+    m_runId = runId;
+    m_isProcessing = true;
+
+    // A segment writer appends to one segment at a time, so packed output
+    // stays on a single worker.
+    m_activeWorkerCount = config.isPackedOutput() ? 1 : qMax(1, config.workerCount());
+    ensureWorkers(m_activeWorkerCount);
+
+    m_processedFileCount = 0;
+    m_fileQueue.clear();
+    m_fileQueue.setPolicy(config.schedulingPolicy());
+    m_scanIterator.reset();
+    m_isScanResumePending = false;
+    m_statistics.reset();
+    applyPlacement();
+    applyMemoryBudget();
+    m_nextFileId = 0;
+
+    m_pendingSnapshot = ProcessingSnapshot();
+    m_pendingSnapshot.runId = runId;
+    markSnapshotDirty();
+
+    logMessage("=== START ===");
+    logMessage("input path: " + config.inputPath());
+    logMessage("output path: " + config.outputPath());
+    logMessage("file mask: " + config.fileMasks().join(','));
+    logMessage("XOR key: " + QString::fromLatin1(config.xorKey().toHex().toUpper()));
+
+    logMessage("workers: " + QString::number(m_activeWorkerCount)
+               + ", scheduling: " + FileQueue::policyName(config.schedulingPolicy()));
+    logMessage("memory budget: " + FileUtils::formatFileSize(config.memoryBudget())
+               + ", buffers: " + FileUtils::formatFileSize(bufferPoolUsage().capacity)
+               + ", queue: " + QString::number(m_fileQueue.capacity()) + " files");
+
+    for (int i = 0; i != m_activeWorkerCount; ++i) {
+        QMetaObject::invokeMethod(m_workers[i].worker, "setCompressionOptions", Qt::QueuedConnection,
+                                  Q_ARG(CompressionOptions, config.compression()));
+    }
+    if (config.compression().isEnabled()) {
+        logMessage("compression: zlib level " + QString::number(config.compression().level));
+    }
+
+    if (config.isPackedOutput()) {
+        QMetaObject::invokeMethod(m_workers[0].worker, "openSegments", Qt::QueuedConnection,
+                                  Q_ARG(QString, config.outputPath()),
+                                  Q_ARG(qint64, config.segmentSize()));
+        logMessage("packed output: segment size " + FileUtils::formatFileSize(config.segmentSize()));
+    }
+
+    if (!config.metricsFilePath().isEmpty()) {
+        m_metricsTimer->start(config.metricsInterval());
+        logMessage("metrics file: " + config.metricsFilePath());
+    }
+
+    if (config.isTimerMode()) {
+        int interval = config.timerInterval();
+        m_processingTimer->start(interval);
+        logMessage("Interval Mode: timer = " + QString::number(interval) + " ms");
+    } else {
+        logMessage("One time Mode");
+        scanForFiles();
+    }
+}
+
+void ProcessingController::stop()
+{
+    if (m_isProcessing) {
+        stopProcessing();
+    }
+}
+
+void ProcessingController::shutdown()
+{
+    m_isProcessing = false;
+    m_processingTimer->stop();
+    m_metricsTimer->stop();
+    m_snapshotTimer->stop();
+
+    for (const WorkerSlot& slot : std::as_const(m_workers)) {
+        slot.thread->quit();
+    }
+    for (const WorkerSlot& slot : std::as_const(m_workers)) {
+        slot.thread->wait(3000);
+    }
+}
+
+void ProcessingController::ensureWorkers(int count)
+{
+    while (m_workers.size() < count) {
+        const int slotIndex = static_cast<int>(m_workers.size());
+
+        WorkerSlot slot;
+        slot.thread = new QThread(this);
+        slot.bufferPool = m_bufferPools.front().get();
+        slot.worker = new Worker(slot.bufferPool);
+        slot.worker->moveToThread(slot.thread);
+
+        connect(slot.thread, &QThread::finished, slot.worker, &QObject::deleteLater);
+        connect(slot.worker, &Worker::errorOccurred, this, [this, slotIndex](const QString& errorMessage) {
+            onWorkerErrorOccurred(slotIndex, errorMessage);
+        });
+        connect(slot.worker, &Worker::progressChanged, this, [this, slotIndex](int percent) {
+            onWorkerProgressChanged(slotIndex, percent);
+        });
+        connect(slot.worker, &Worker::finished, this, [this, slotIndex]() {
+            onWorkerFinished(slotIndex);
+        });
+        connect(slot.worker, &Worker::statusChanged, this, &ProcessingController::onWorkerStatusChanged);
+        connect(slot.worker, &Worker::inputFileDeleted, this, &ProcessingController::onWorkerInputFileDeleted);
+        connect(slot.worker, &Worker::metricsReady, this, [this, slotIndex](const FileMetrics& metrics) {
+            onWorkerMetricsReady(slotIndex, metrics);
+        });
+
+        slot.thread->start();
+        m_workers.append(slot);
+    }
+}
+
+// With NUMA placement the active workers are spread round-robin over the
+// nodes that have CPUs in the configured set, pinned to those CPUs and given
+// their node's buffer pool. Without it they are pinned to the CPU set, if
+// any. On a single-node machine nothing but the CPU set applies.
+void ProcessingController::applyPlacement()
+{
+    const QList<CpuTopology::Node> nodes = CpuTopology::nodes();
+    const QList<int> cpuSet = m_config.cpuSet();
+
+    QList<int> nodeIndexes;
+    if (m_config.isNumaAware()) {
+        for (int i = 0; i != nodes.size() && CpuTopology::isNuma(); ++i) {
+            if (!intersectCpus(nodes.at(i).cpus, cpuSet).isEmpty()) {
+                nodeIndexes.append(i);
+            }
+        }
+        if (nodeIndexes.isEmpty()) {
+            logMessage("NUMA placement: single node, workers are not spread");
+        }
+    }
+
+    for (int i = 0; i != m_activeWorkerCount; ++i) {
+        WorkerSlot& slot = m_workers[i];
+        QList<int> cpus = cpuSet;
+        slot.bufferPool = m_bufferPools.front().get();
+
+        if (!nodeIndexes.isEmpty()) {
+            const int nodeIndex = nodeIndexes.at(i % nodeIndexes.size());
+            cpus = intersectCpus(nodes.at(nodeIndex).cpus, cpuSet);
+            slot.bufferPool = m_bufferPools.at(nodeIndex + 1).get();
+            logMessage(QString("worker %1: node %2, cpus %3")
+                           .arg(i).arg(nodes.at(nodeIndex).id).arg(CpuTopology::formatCpuList(cpus)),
+                       LogLevel::Debug);
+        } else if (!cpus.isEmpty()) {
+            logMessage(QString("worker %1: cpus %2").arg(i).arg(CpuTopology::formatCpuList(cpus)),
+                       LogLevel::Debug);
+        }
+
+        Worker *worker = slot.worker;
+        BufferPool *bufferPool = slot.bufferPool;
+        Logger *logger = m_logger;
+        QMetaObject::invokeMethod(worker, [worker, cpus, bufferPool, logger]() {
+            if (!worker->setPlacement(cpus, bufferPool)) {
+                logger->log(LogLevel::Warning, "cannot pin worker thread to cpus " + CpuTopology::formatCpuList(cpus));
+            }
+        }, Qt::QueuedConnection);
+    }
+}
+
+// One eighth of the budget bounds the queue, the rest the I/O buffers and
+// compression batches, split evenly over the pools in use. Every active
+// worker is always guaranteed its one buffer; batches on top of that wait
+// for room in the pool.
+void ProcessingController::applyMemoryBudget()
+{
+    const qint64 budget = m_config.memoryBudget();
+    const qint64 queueBudget = budget / 8;
+
+    m_fileQueue.setCapacity(static_cast<int>(qBound<qint64>(minQueueCapacity, queueBudget / queueEntryCost,
+                                                            std::numeric_limits<int>::max())));
+
+    QHash<BufferPool*, int> workersPerPool;
+    for (int i = 0; i != m_activeWorkerCount; ++i) {
+        workersPerPool[m_workers[i].bufferPool]++;
+    }
+
+    const qint64 poolBudget = (budget - queueBudget) / qMax<qsizetype>(1, workersPerPool.size());
+    for (const std::unique_ptr<BufferPool>& pool : m_bufferPools) {
+        const int workerCount = workersPerPool.value(pool.get());
+        pool->setCapacity(workerCount > 0 ? qMax(poolBudget, workerCount * workerBufferSize) : 0);
+        pool->resetCounters();
+    }
+}
+
+BufferPool::Usage ProcessingController::bufferPoolUsage() const
+{
+    BufferPool::Usage total;
+    for (const std::unique_ptr<BufferPool>& pool : m_bufferPools) {
+        const BufferPool::Usage usage = pool->usage();
+        total.capacity += usage.capacity;
+        total.allocated += usage.allocated;
+        total.inUse += usage.inUse;
+        total.peakInUse += usage.peakInUse;
+        total.waitCount += usage.waitCount;
+    }
+    return total;
+}
+
+void ProcessingController::stopProcessing(bool noFilesFound)
+{
+    m_isProcessing = false;
+    m_processingTimer->stop();
+    m_scanIterator.reset();
+
+    if (m_config.isPackedOutput()) {
+        QMetaObject::invokeMethod(m_workers[0].worker, "closeSegments", Qt::QueuedConnection);
+    }
+
+    logStatistics();
+
+    if (m_metricsTimer->isActive()) {
+        m_metricsTimer->stop();
+        writeMetricsFile();
+    }
+
+    publishSnapshot();
+    emit processingStopped(m_runId, noFilesFound);
+}
+
+void ProcessingController::scanForFiles()
+{
+    if (!m_isProcessing) return;
+
+    // A scan paused by a full queue resumes where it stopped; a timer tick
+    // does not start it over.
+    if (m_scanIterator) {
+        return;
+    }
+
+    QDir directory(m_config.inputPath());
+
+    if (!directory.exists()) {
+        logMessage("error: input directory doesnt exist", LogLevel::Error);
+        stopProcessing();
+        return;
+    }
+
+    QStringList masks;
+    for (const QString& mask : m_config.fileMasks()) {
+        masks.append(mask.trimmed());
+    }
+
+    // Entries arrive in the file system's listing order rather than sorted by
+    // name: sorting would need the whole listing in memory, which the scan
+    // backpressure is there to avoid. That is the order Fifo dispatches in.
+    m_scanIterator = std::make_unique<QDirIterator>(directory.absolutePath(), masks,
+                                                    QDir::Files | QDir::NoDotAndDotDot);
+    m_scanFoundCount = 0;
+    continueScan();
+}
+
+void ProcessingController::continueScan()
+{
+    m_isScanResumePending = false;
+    if (!m_isProcessing || !m_scanIterator) {
+        return;
+    }
+
+    QElapsedTimer scanTimer;
+    scanTimer.start();
+
+    // Sizes come from the scan itself, so scheduling costs no extra stat.
+    const qint64 enqueueTime = m_queueClock.nsecsElapsed();
+    int foundCount = 0;
+
+    while (!m_fileQueue.isFull() && m_scanIterator->hasNext()) {
+        const QFileInfo fileInfo = m_scanIterator->nextFileInfo();
+        if (shouldProcessFile(fileInfo)) {
+            m_fileQueue.push(fileInfo.absoluteFilePath(), fileInfo.size(), enqueueTime);
+            foundCount++;
+        }
+    }
+
+    const bool isScanComplete = !m_scanIterator->hasNext();
+    m_scanFoundCount += foundCount;
+    m_statistics.addScanTime(scanTimer.nsecsElapsed());
+
+    if (isScanComplete) {
+        m_scanIterator.reset();
+        if (m_scanFoundCount > 0) {
+            logMessage("Found " + QString::number(m_scanFoundCount) + " file(s) to process");
+        }
+    } else {
+        logMessage("queue is full (" + QString::number(m_fileQueue.size()) + " files), scan paused",
+                   LogLevel::Debug);
+    }
+
+    if (foundCount > 0) {
+        markSnapshotDirty();
+        dispatchFiles();
+    }
+
+    if (isScanComplete && !m_config.isTimerMode() && m_fileQueue.isEmpty() && !isAnyWorkerBusy()) {
+        if (m_scanFoundCount == 0) {
+            logMessage("Files with current masks not found");
+        }
+        stopProcessing(m_scanFoundCount == 0);
+    }
+}
+
+bool ProcessingController::shouldProcessFile(const QFileInfo& fileInfo) const
+{
+    const QString filePath = fileInfo.absoluteFilePath();
+
+    if (isFileInFlight(filePath)) {
+        return false;
+    }
+
+    if (m_fileQueue.contains(filePath)) {
+        return false;
+    }
+
+    return fileInfo.isReadable();
+}
+
+bool ProcessingController::isFileInFlight(const QString& filePath) const
+{
+    for (const WorkerSlot& slot : m_workers) {
+        if (slot.isBusy && slot.inputFile == filePath) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ProcessingController::isAnyWorkerBusy() const
+{
+    for (const WorkerSlot& slot : m_workers) {
+        if (slot.isBusy) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// With more than one worker the first is kept as a small-file lane under the
+// largest-first policy, so small files never queue behind the big ones.
+bool ProcessingController::isSmallFileLane(int slotIndex) const
+{
+    return slotIndex == 0 && m_activeWorkerCount > 1;
+}
+
+void ProcessingController::dispatchFiles()
+{
+    for (int i = 0; i != m_activeWorkerCount && !m_fileQueue.isEmpty(); ++i) {
+        if (!m_workers[i].isBusy) {
+            processNextFile(i);
+        }
+    }
+}
+
+void ProcessingController::processNextFile(int slotIndex)
+{
+    WorkerSlot& slot = m_workers[slotIndex];
+    if (m_fileQueue.isEmpty() || slot.isBusy) {
+        return;
+    }
+
+    const FileQueue::Entry entry = m_fileQueue.takeNext(isSmallFileLane(slotIndex));
+    if (m_scanIterator && !m_isScanResumePending && m_fileQueue.size() <= m_fileQueue.capacity() / 2) {
+        m_isScanResumePending = true;
+        QMetaObject::invokeMethod(this, &ProcessingController::continueScan, Qt::QueuedConnection);
+    }
+
+    slot.queueWaitNs = m_queueClock.nsecsElapsed() - entry.enqueueNs;
+    slot.inputFile = entry.filePath;
+    slot.inputSize = entry.size;
+    slot.isBusy = true;
+    slot.hasFailed = false;
+    slot.runId = m_runId;
+    slot.progress = 0;
+
+    QFileInfo fileInfo(entry.filePath);
+
+    QString outputFileName = fileInfo.fileName();
+    if (m_config.compression().isEnabled() && !m_config.isPackedOutput()) {
+        outputFileName += compressedFileSuffix;
+    }
+    QString fullOutputPath = QDir(m_config.outputPath()).absoluteFilePath(outputFileName);
+
+    // Names still being written by other workers count as taken, so two
+    // conflicting files never pick the same counter.
+    if (!m_config.isPackedOutput() && m_config.addCounterOnConflict()
+        && (QFile::exists(fullOutputPath) || m_reservedOutputNames.contains(outputFileName))) {
+        outputFileName = FileUtils::generateUniqueFileName(m_config.outputPath(), outputFileName,
+                                                           m_reservedOutputNames);
+        fullOutputPath = QDir(m_config.outputPath()).absoluteFilePath(outputFileName);
+    }
+    slot.outputName = outputFileName;
+    m_reservedOutputNames.insert(outputFileName);
+
+    logFileProcessingStart(fileInfo, outputFileName);
+
+    ProcessingSnapshot::StartedFile startedFile;
+    startedFile.fileId = slot.fileId = m_nextFileId++;
+    startedFile.directory = fileInfo.absolutePath();
+    startedFile.inputName = fileInfo.fileName();
+    startedFile.outputName = outputFileName;
+    startedFile.size = slot.inputSize;
+    m_pendingSnapshot.startedFiles.append(startedFile);
+    markSnapshotDirty();
+
+    QMetaObject::invokeMethod(slot.worker, "processFile",
+                              Qt::QueuedConnection,
+                              Q_ARG(QString, entry.filePath),
+                              Q_ARG(QString, fullOutputPath),
+                              Q_ARG(QByteArray, m_config.xorKey()),
+                              Q_ARG(bool, m_config.deleteInputFiles())
+                              );
+}
+
+void ProcessingController::onWorkerProgressChanged(int slotIndex, int percent)
+{
+    m_workers[slotIndex].progress = percent;
+
+    int totalProgress = 0;
+    int busyCount = 0;
+    for (const WorkerSlot& slot : std::as_const(m_workers)) {
+        if (slot.isBusy) {
+            totalProgress += slot.progress;
+            busyCount++;
+        }
+    }
+
+    m_pendingSnapshot.progress = busyCount > 0 ? totalProgress / busyCount : percent;
+    markSnapshotDirty();
+}
+
+void ProcessingController::onWorkerStatusChanged(const QString& status)
+{
+    m_pendingSnapshot.status = status;
+    markSnapshotDirty();
+}
+
+void ProcessingController::onWorkerFinished(int slotIndex)
+{
+    WorkerSlot& slot = m_workers[slotIndex];
+    slot.isBusy = false;
+    m_reservedOutputNames.remove(slot.outputName);
+
+    // A file from a run that was stopped and restarted meanwhile belongs to
+    // neither run's statistics.
+    if (slot.runId == m_runId && !slot.inputFile.isEmpty() && !slot.hasFailed) {
+        m_processedFileCount++;
+        m_statistics.addSuccess(slot.inputSize);
+
+        logFileProcessingSuccess(QFileInfo(slot.inputFile).fileName(), slot.inputSize, slot.queueWaitNs);
+    }
+    slot.inputFile.clear();
+    slot.outputName.clear();
+
+    if (!m_isProcessing) {
+        return;
+    }
+
+    if (!m_fileQueue.isEmpty()) {
+        if (slotIndex < m_activeWorkerCount) {
+            processNextFile(slotIndex);
+        }
+    } else if (!m_config.isTimerMode() && !m_scanIterator && !isAnyWorkerBusy()) {
+        stopProcessing();
+    }
+}
+
+void ProcessingController::onWorkerErrorOccurred(int slotIndex, const QString& errorMessage)
+{
+    WorkerSlot& slot = m_workers[slotIndex];
+    if (slot.runId != m_runId) {
+        return;
+    }
+
+    m_statistics.addError();
+    logFileProcessingError(slot.inputFile, errorMessage);
+
+    ProcessingSnapshot::CompletedFile completedFile;
+    completedFile.fileId = slot.fileId;
+    completedFile.success = false;
+    m_pendingSnapshot.completedFiles.append(completedFile);
+
+    if (m_pendingSnapshot.errors.size() < maxErrorsPerSnapshot) {
+        m_pendingSnapshot.errors.append(errorMessage);
+    }
+    markSnapshotDirty();
+
+    // The worker still emits finished() after an error; the flag keeps the
+    // file from being counted as a success there.
+    slot.hasFailed = true;
+}
+
+void ProcessingController::onWorkerInputFileDeleted(const QString& filePath, bool success)
+{
+    if (success) {
+        logMessage("Входной файл удален: " + filePath, LogLevel::Debug);
+    } else {
+        logMessage("Ошибка удаления входного файла: " + filePath, LogLevel::Warning);
+    }
+}
+
+void ProcessingController::onWorkerMetricsReady(int slotIndex, const FileMetrics& metrics)
+{
+    const WorkerSlot& slot = m_workers[slotIndex];
+    if (slot.runId != m_runId) {
+        return;
+    }
+
+    FileMetrics fileMetrics = metrics;
+    fileMetrics.queueWaitNs = slot.queueWaitNs;
+    m_statistics.addFileMetrics(fileMetrics);
+
+    ProcessingSnapshot::CompletedFile completedFile;
+    completedFile.fileId = slot.fileId;
+    completedFile.success = true;
+    completedFile.durationUs = metrics.processingNs / 1000;
+    m_pendingSnapshot.completedFiles.append(completedFile);
+    markSnapshotDirty();
+}
+
+void ProcessingController::markSnapshotDirty()
+{
+    m_isSnapshotDirty = true;
+    if (!m_snapshotTimer->isActive()) {
+        m_snapshotTimer->start();
+    }
+}
+
+void ProcessingController::publishSnapshot()
+{
+    m_snapshotTimer->stop();
+
+    if (!m_isSnapshotDirty) {
+        return;
+    }
+
+    m_pendingSnapshot.successCount = m_statistics.successCount();
+    m_pendingSnapshot.errorCount = m_statistics.errorCount();
+    m_pendingSnapshot.totalBytesProcessed = m_statistics.totalBytesProcessed();
+    m_pendingSnapshot.queueLength = m_fileQueue.size();
+
+    emit snapshotReady(m_pendingSnapshot);
+
+    m_pendingSnapshot.startedFiles.clear();
+    m_pendingSnapshot.completedFiles.clear();
+    m_pendingSnapshot.errors.clear();
+    m_pendingSnapshot.status.clear();
+    m_isSnapshotDirty = false;
+}
+
+void ProcessingController::writeMetricsFile()
+{
+    if (m_config.metricsFilePath().isEmpty()) {
+        return;
+    }
+
+    m_statistics.setQueueLength(m_fileQueue.size());
+    m_statistics.setBufferPoolUsage(bufferPoolUsage());
+
+    QSaveFile file(m_config.metricsFilePath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        logMessage("Ошибка записи файла метрик: " + m_config.metricsFilePath(), LogLevel::Warning);
+        return;
+    }
+
+    file.write(m_statistics.toPrometheusText().toUtf8());
+    if (!file.commit()) {
+        logMessage("Ошибка записи файла метрик: " + m_config.metricsFilePath(), LogLevel::Warning);
+    }
+}
+
+void ProcessingController::logMessage(const QString& message, LogLevel level)
+{
+    m_logger->log(level, message);
+}
+
+void ProcessingController::logFileProcessingStart(const QFileInfo& fileInfo, const QString& outputFileName)
+{
+    if (!m_logger->isEnabled(LogLevel::Debug)) {
+        return;
+    }
+
+    QString sizeStr = FileUtils::formatFileSize(fileInfo);
+    logMessage(">>> Начата обработка: " + fileInfo.fileName() + " (" + sizeStr + ") -> " + outputFileName,
+               LogLevel::Debug);
+}
+
+void ProcessingController::logFileProcessingSuccess(const QString& fileName, qint64 fileSize, qint64 queueWaitNs)
+{
+    if (!m_logger->isEnabled(LogLevel::Debug)) {
+        return;
+    }
+
+    QString sizeStr = FileUtils::formatFileSize(fileSize);
+    QString waitStr = QString::number(queueWaitNs / 1e6, 'f', 1);
+    logMessage("<<< Успешно обработан: " + fileName + " (" + sizeStr + "), ожидание в очереди " + waitStr + " мс",
+               LogLevel::Debug);
+}
+
+void ProcessingController::logFileProcessingError(const QString& inputFile, const QString& errorMessage)
+{
+    logMessage("!!! Ошибка обработки: " + errorMessage, LogLevel::Error);
+
+    if (!inputFile.isEmpty()) {
+        logMessage("!!! Файл с ошибкой: " + QFileInfo(inputFile).fileName(), LogLevel::Error);
+    }
+}
+
+void ProcessingController::logStatistics()
+{
+    logMessage("=== STOP ===");
+    logMessage("processed files count: " + QString::number(m_processedFileCount));
+    logMessage("Успешно обработано: " + QString::number(m_statistics.successCount()) + " файлов");
+    logMessage("Ошибок обработки: " + QString::number(m_statistics.errorCount()) + " файлов");
+    logMessage("Всего обработано данных: " + m_statistics.getFormattedSize());
+    logMessage(m_statistics.getLatencySummary());
+    m_statistics.setBufferPoolUsage(bufferPoolUsage());
+    logMessage(m_statistics.getMemorySummary());
+}
@@ -0,0 +1,133 @@
+#ifndef PROCESSINGCONTROLLER_H
+#define PROCESSINGCONTROLLER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QSet>
+#include "bufferpool.h"
+#include "fileprocessorconfig.h"
+#include "filequeue.h"
+#include "logger.h"
+#include "processingsnapshot.h"
+#include "processingstatistics.h"
+#include "worker.h"
+
+#include <memory>
+#include <vector>
+
+class QDirIterator;
+class QFileInfo;
+class QThread;
+class QTimer;
+
+// Owns scanning, the file queue, dispatch to the worker pool, statistics and
+// the metrics file. Meant to live on its own thread: the UI only starts/stops it
+// and receives batched ProcessingSnapshots, so a busy or blocked GUI thread
+// never holds up the pipeline.
+class ProcessingController : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ProcessingController(Logger *logger, QObject *parent = nullptr);
+    ~ProcessingController() override;
+
+public slots:
+    void start(const FileProcessorConfig& config, int runId);
+    void stop();
+    void shutdown();
+
+signals:
+    void snapshotReady(const ProcessingSnapshot& snapshot);
+    void processingStopped(int runId, bool noFilesFound);
+
+private slots:
+    void scanForFiles();
+    void publishSnapshot();
+    void writeMetricsFile();
+
+private:
+    // One worker thread and the file it is currently processing.
+    struct WorkerSlot
+    {
+        Worker *worker = nullptr;
+        QThread *thread = nullptr;
+        bool isBusy = false;
+        bool hasFailed = false;
+        int runId = 0;
+        int progress = 0;
+        QString inputFile;
+        QString outputName;
+        qint64 inputSize = 0;
+        int fileId = -1;
+        qint64 queueWaitNs = 0;
+        BufferPool *bufferPool = nullptr;
+    };
+
+    static const int snapshotInterval = 100; // ms
+    static const int maxErrorsPerSnapshot = 100;
+    static constexpr const char* compressedFileSuffix = ".xzc";
+    static const qint64 workerBufferSize = 64 * 1024; // 64Kb
+    // Rough resident cost of one queued file (path, hash and ordering nodes).
+    static const qint64 queueEntryCost = 512;
+    static const int minQueueCapacity = 64;
+
+    Logger *m_logger;
+    // [0] serves unplaced workers; on NUMA machines [1 + i] belongs to
+    // CpuTopology::nodes()[i].
+    std::vector<std::unique_ptr<BufferPool>> m_bufferPools;
+    QList<WorkerSlot> m_workers;
+    int m_activeWorkerCount = 1;
+    QTimer *m_processingTimer;
+    QTimer *m_metricsTimer;
+    QTimer *m_snapshotTimer;
+
+    FileProcessorConfig m_config;
+    int m_runId = 0;
+    bool m_isProcessing = false;
+    int m_nextFileId = 0;
+
+    int m_processedFileCount = 0;
+    QSet<QString> m_reservedOutputNames;
+    FileQueue m_fileQueue;
+    QElapsedTimer m_queueClock;
+
+    // The scan in progress. It pauses while the queue is full and resumes once
+    // dispatch has drained it to half, so queued paths never outgrow the budget.
+    std::unique_ptr<QDirIterator> m_scanIterator;
+    int m_scanFoundCount = 0;
+    bool m_isScanResumePending = false;
+
+    ProcessingStatistics m_statistics;
+    ProcessingSnapshot m_pendingSnapshot;
+    bool m_isSnapshotDirty = false;
+
+    void stopProcessing(bool noFilesFound = false);
+    void applyPlacement();
+    void applyMemoryBudget();
+    BufferPool::Usage bufferPoolUsage() const;
+    void continueScan();
+    void ensureWorkers(int count);
+    void dispatchFiles();
+    void processNextFile(int slotIndex);
+    bool isSmallFileLane(int slotIndex) const;
+    bool isAnyWorkerBusy() const;
+    bool isFileInFlight(const QString& filePath) const;
+    bool shouldProcessFile(const QFileInfo& fileInfo) const;
+    void markSnapshotDirty();
+
+    void onWorkerProgressChanged(int slotIndex, int percent);
+    void onWorkerStatusChanged(const QString& status);
+    void onWorkerFinished(int slotIndex);
+    void onWorkerErrorOccurred(int slotIndex, const QString& errorMessage);
+    void onWorkerInputFileDeleted(const QString& filePath, bool success);
+    void onWorkerMetricsReady(int slotIndex, const FileMetrics& metrics);
+
+    void logMessage(const QString& message, LogLevel level = LogLevel::Info);
+    void logFileProcessingStart(const QFileInfo& fileInfo, const QString& outputFileName);
+    void logFileProcessingSuccess(const QString& fileName, qint64 fileSize, qint64 queueWaitNs);
+    void logFileProcessingError(const QString& inputFile, const QString& errorMessage);
+    void logStatistics();
+};
+
+#endif // PROCESSINGCONTROLLER_H
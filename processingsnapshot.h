@@ -0,0 +1,46 @@
+#ifndef PROCESSINGSNAPSHOT_H
+#define PROCESSINGSNAPSHOT_H
+
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include <QStringList>
+
+// Everything the UI needs to know about the pipeline since the previous
+// snapshot. File ids are assigned in dispatch order starting at 0 for every
+// run, which matches the ids handed out by FileListModel::addFile.
+struct ProcessingSnapshot
+{
+    struct StartedFile
+    {
+        int fileId = -1;
+        QString directory;
+        QString inputName;
+        QString outputName;
+        qint64 size = 0;
+    };
+
+    struct CompletedFile
+    {
+        int fileId = -1;
+        bool success = false;
+        qint64 durationUs = 0;
+    };
+
+    int runId = 0;
+    int progress = 0;
+    QString status;
+
+    int successCount = 0;
+    int errorCount = 0;
+    qint64 totalBytesProcessed = 0;
+    int queueLength = 0;
+
+    QList<StartedFile> startedFiles;
+    QList<CompletedFile> completedFiles;
+    QStringList errors;
+};
+
+Q_DECLARE_METATYPE(ProcessingSnapshot)
+
+#endif // PROCESSINGSNAPSHOT_H
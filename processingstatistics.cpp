@@ -5,6 +5,13 @@ void ProcessingStatistics::reset()
     m_successCount = 0;
     m_errorCount = 0;
     m_totalBytesProcessed = 0;
+    m_totalBytesWritten = 0;
+    m_queueLength = 0;
+    m_bufferPoolUsage = BufferPool::Usage();
+    m_processingTime.reset();
+    m_queueWaitTime.reset();
+    m_throughput.reset();
+    m_phaseNs.fill(0);
 }
 
 void ProcessingStatistics::addSuccess(qint64 fileSize)
@@ -18,6 +25,27 @@ void ProcessingStatistics::addError()
     m_errorCount++;
 }
 
+void ProcessingStatistics::addFileMetrics(const FileMetrics& metrics)
+{
+    const double processingSeconds = metrics.processingNs / 1e9;
+
+    m_totalBytesWritten += metrics.outputBytes;
+    m_processingTime.record(processingSeconds);
+    m_queueWaitTime.record(metrics.queueWaitNs / 1e9);
+    if (processingSeconds > 0.0) {
+        m_throughput.record(metrics.bytes / (1024.0 * 1024.0) / processingSeconds);
+    }
+
+    for (int phase = 0; phase != FileMetrics::PhaseCount; ++phase) {
+        m_phaseNs[phase] += metrics.phaseNs[phase];
+    }
+}
+
+void ProcessingStatistics::addScanTime(qint64 nanoseconds)
+{
+    m_phaseNs[FileMetrics::Scan] += nanoseconds;
+}
+
 QString ProcessingStatistics::formatBytes(qint64 bytes)
 {
     if (bytes < 1024) {
@@ -44,3 +72,86 @@ QString ProcessingStatistics::getSummary() const
     summary += "Всего обработано данных: " + getFormattedSize();
     return summary;
 }
+
+QString ProcessingStatistics::getLatencySummary() const
+{
+    auto milliseconds = [](double seconds) {
+        return QString::number(seconds * 1000.0, 'f', 2);
+    };
+
+    return QString("Время обработки p50/p95/p99: %1 / %2 / %3 мс; ожидание в очереди p50/p95/p99: %4 / %5 / %6 мс")
+        .arg(milliseconds(m_processingTime.percentile(0.50)),
+             milliseconds(m_processingTime.percentile(0.95)),
+             milliseconds(m_processingTime.percentile(0.99)),
+             milliseconds(m_queueWaitTime.percentile(0.50)),
+             milliseconds(m_queueWaitTime.percentile(0.95)),
+             milliseconds(m_queueWaitTime.percentile(0.99)));
+}
+
+QString ProcessingStatistics::getMemorySummary() const
+{
+    return QString("Буферы ввода-вывода: занято %1, выделено %2 из %3, пик %4, ожиданий %5")
+        .arg(formatBytes(m_bufferPoolUsage.inUse),
+             formatBytes(m_bufferPoolUsage.allocated),
+             formatBytes(m_bufferPoolUsage.capacity),
+             formatBytes(m_bufferPoolUsage.peakInUse))
+        .arg(m_bufferPoolUsage.waitCount);
+}
+
+QString ProcessingStatistics::toPrometheusText() const
+{
+    QString text;
+
+    auto appendSummary = [&text](const QString& name, const QString& help, const Histogram& histogram) {
+        text += "# HELP " + name + " " + help + "\n";
+        text += "# TYPE " + name + " summary\n";
+        for (double quantile : {0.5, 0.95, 0.99}) {
+            text += QString("%1{quantile=\"%2\"} %3\n")
+                        .arg(name).arg(quantile).arg(histogram.percentile(quantile));
+        }
+        text += QString("%1_sum %2\n").arg(name).arg(histogram.sum());
+        text += QString("%1_count %2\n").arg(name).arg(histogram.count());
+    };
+
+    text += "# HELP filexor_files_total Files handled by the processor.\n";
+    text += "# TYPE filexor_files_total counter\n";
+    text += QString("filexor_files_total{result=\"success\"} %1\n").arg(m_successCount);
+    text += QString("filexor_files_total{result=\"error\"} %1\n").arg(m_errorCount);
+
+    text += "# HELP filexor_bytes_total Input bytes transformed successfully.\n";
+    text += "# TYPE filexor_bytes_total counter\n";
+    text += QString("filexor_bytes_total %1\n").arg(m_totalBytesProcessed);
+
+    text += "# HELP filexor_output_bytes_total Bytes written to the output volume.\n";
+    text += "# TYPE filexor_output_bytes_total counter\n";
+    text += QString("filexor_output_bytes_total %1\n").arg(m_totalBytesWritten);
+
+    text += "# HELP filexor_queue_length Files waiting to be dispatched.\n";
+    text += "# TYPE filexor_queue_length gauge\n";
+    text += QString("filexor_queue_length %1\n").arg(m_queueLength);
+
+    text += "# HELP filexor_buffer_pool_bytes I/O buffer pool memory.\n";
+    text += "# TYPE filexor_buffer_pool_bytes gauge\n";
+    text += QString("filexor_buffer_pool_bytes{state=\"capacity\"} %1\n").arg(m_bufferPoolUsage.capacity);
+    text += QString("filexor_buffer_pool_bytes{state=\"allocated\"} %1\n").arg(m_bufferPoolUsage.allocated);
+    text += QString("filexor_buffer_pool_bytes{state=\"in_use\"} %1\n").arg(m_bufferPoolUsage.inUse);
+    text += QString("filexor_buffer_pool_bytes{state=\"peak\"} %1\n").arg(m_bufferPoolUsage.peakInUse);
+
+    text += "# HELP filexor_buffer_pool_waits_total Times a worker waited for a free buffer.\n";
+    text += "# TYPE filexor_buffer_pool_waits_total counter\n";
+    text += QString("filexor_buffer_pool_waits_total %1\n").arg(m_bufferPoolUsage.waitCount);
+
+    appendSummary("filexor_file_processing_seconds", "Time spent in the worker per file.", m_processingTime);
+    appendSummary("filexor_queue_wait_seconds", "Time a file waited in the queue before dispatch.", m_queueWaitTime);
+    appendSummary("filexor_file_throughput_mbps", "Per-file throughput in MiB/s.", m_throughput);
+
+    text += "# HELP filexor_phase_seconds_total Cumulative time spent per processing phase.\n";
+    text += "# TYPE filexor_phase_seconds_total counter\n";
+    for (int phase = 0; phase != FileMetrics::PhaseCount; ++phase) {
+        text += QString("filexor_phase_seconds_total{phase=\"%1\"} %2\n")
+                    .arg(FileMetrics::phaseName(static_cast<FileMetrics::Phase>(phase)))
+                    .arg(m_phaseNs[phase] / 1e9);
+    }
+
+    return text;
+}
@@ -2,6 +2,9 @@
 #define PROCESSINGSTATISTICS_H
 
 #include <QString>
+#include "bufferpool.h"
+#include "filemetrics.h"
+#include "histogram.h"
 
 class ProcessingStatistics
 {
@@ -11,19 +14,40 @@ public:
     void reset();
     void addSuccess(qint64 fileSize);
     void addError();
+    void addFileMetrics(const FileMetrics& metrics);
+    void addScanTime(qint64 nanoseconds);
+    void setQueueLength(int length) { m_queueLength = length; }
+    void setBufferPoolUsage(const BufferPool::Usage& usage) { m_bufferPoolUsage = usage; }
 
     int successCount() const { return m_successCount; }
     int errorCount() const { return m_errorCount; }
     qint64 totalBytesProcessed() const { return m_totalBytesProcessed; }
+    qint64 totalBytesWritten() const { return m_totalBytesWritten; }
     int totalFiles() const { return m_successCount + m_errorCount; }
+    const BufferPool::Usage& bufferPoolUsage() const { return m_bufferPoolUsage; }
+
+    const Histogram& processingTime() const { return m_processingTime; }
+    const Histogram& queueWaitTime() const { return m_queueWaitTime; }
+    const Histogram& throughput() const { return m_throughput; }
 
     QString getFormattedSize() const;
     QString getSummary() const;
+    QString getLatencySummary() const;
+    QString getMemorySummary() const;
+    QString toPrometheusText() const;
 
 private:
     int m_successCount = 0;
     int m_errorCount = 0;
     qint64 m_totalBytesProcessed = 0;
+    qint64 m_totalBytesWritten = 0;
+    int m_queueLength = 0;
+    BufferPool::Usage m_bufferPoolUsage;
+
+    Histogram m_processingTime;
+    Histogram m_queueWaitTime;
+    Histogram m_throughput;
+    std::array<qint64, FileMetrics::PhaseCount> m_phaseNs {};
 
     static QString formatBytes(qint64 bytes);
 };
@@ -0,0 +1,14 @@
+QT       = core
+
+TARGET = tst_bufferpool
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_bufferpool.cpp \
+    ../../bufferpool.cpp
+
+HEADERS += \
+    ../../bufferpool.h
+
+include(../tests.pri)
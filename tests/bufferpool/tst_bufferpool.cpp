@@ -0,0 +1,130 @@
+#include <QTest>
+#include <QThread>
+#include "bufferpool.h"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace {
+
+const qint64 bufferSize = 64 * 1024; // 64Kb
+
+// Acquires a buffer with the given charge on its own thread and holds it
+// until the thread is waited for.
+std::unique_ptr<QThread> startAcquire(BufferPool& pool, qint64 charge, std::atomic<bool>& isAcquired)
+{
+    std::unique_ptr<QThread> thread(QThread::create([&pool, charge, &isAcquired]() {
+        BufferPool::Buffer buffer = pool.acquire(charge);
+        isAcquired = true;
+    }));
+    thread->start();
+    return thread;
+}
+
+} // namespace
+
+class TestBufferPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void reusesReleasedBuffers();
+    void acquireBlocksAtCapacity();
+    void chargeCountsAgainstCapacity();
+    void chargeIsCutDownToCapacity();
+    void loweredCapacityFreesIdleBuffers();
+};
+
+void TestBufferPool::reusesReleasedBuffers()
+{
+    BufferPool pool(bufferSize, 2 * bufferSize);
+    char* data = nullptr;
+
+    {
+        BufferPool::Buffer buffer = pool.acquire();
+        data = buffer.data();
+        QCOMPARE(buffer.size(), bufferSize);
+        QCOMPARE(reinterpret_cast<quintptr>(data) % BufferPool::pageSize, quintptr(0));
+    }
+
+    BufferPool::Buffer buffer = pool.acquire();
+    QCOMPARE(buffer.data(), data);
+    QCOMPARE(pool.usage().allocated, bufferSize);
+}
+
+void TestBufferPool::acquireBlocksAtCapacity()
+{
+    BufferPool pool(bufferSize, 2 * bufferSize);
+    std::optional<BufferPool::Buffer> first(pool.acquire());
+    BufferPool::Buffer second = pool.acquire();
+
+    std::atomic<bool> isAcquired = false;
+    std::unique_ptr<QThread> thread = startAcquire(pool, 0, isAcquired);
+
+    QTRY_COMPARE(pool.usage().waitCount, qint64(1));
+    QTest::qWait(50);
+    QVERIFY(!isAcquired);
+
+    first.reset();
+    QVERIFY(thread->wait(5000));
+    QVERIFY(isAcquired);
+    QCOMPARE(pool.usage().allocated, 2 * bufferSize);
+}
+
+void TestBufferPool::chargeCountsAgainstCapacity()
+{
+    BufferPool pool(bufferSize, 4 * bufferSize);
+    std::optional<BufferPool::Buffer> charged(pool.acquire(2 * bufferSize));
+    QCOMPARE(charged->charge(), 2 * bufferSize);
+
+    BufferPool::Buffer plain = pool.acquire();
+    QCOMPARE(pool.usage().inUse, 4 * bufferSize);
+
+    std::atomic<bool> isAcquired = false;
+    std::unique_ptr<QThread> thread = startAcquire(pool, bufferSize, isAcquired);
+
+    QTRY_COMPARE(pool.usage().waitCount, qint64(1));
+    QTest::qWait(50);
+    QVERIFY(!isAcquired);
+
+    charged.reset();
+    QVERIFY(thread->wait(5000));
+    QVERIFY(isAcquired);
+    QCOMPARE(pool.usage().inUse, bufferSize);
+    QCOMPARE(pool.usage().peakInUse, 4 * bufferSize);
+}
+
+void TestBufferPool::chargeIsCutDownToCapacity()
+{
+    BufferPool pool(bufferSize, 4 * bufferSize);
+    std::optional<BufferPool::Buffer> charged(pool.acquire(100 * bufferSize));
+    QCOMPARE(charged->charge(), 3 * bufferSize);
+    QCOMPARE(pool.usage().inUse, 4 * bufferSize);
+
+    std::atomic<bool> isAcquired = false;
+    std::unique_ptr<QThread> thread = startAcquire(pool, 0, isAcquired);
+
+    QTRY_COMPARE(pool.usage().waitCount, qint64(1));
+    QVERIFY(!isAcquired);
+
+    charged.reset();
+    QVERIFY(thread->wait(5000));
+    QVERIFY(isAcquired);
+}
+
+void TestBufferPool::loweredCapacityFreesIdleBuffers()
+{
+    BufferPool pool(bufferSize, 4 * bufferSize);
+    {
+        BufferPool::Buffer first = pool.acquire();
+        BufferPool::Buffer second = pool.acquire();
+    }
+    QCOMPARE(pool.usage().allocated, 2 * bufferSize);
+
+    pool.setCapacity(bufferSize);
+    QCOMPARE(pool.usage().allocated, bufferSize);
+}
+
+QTEST_GUILESS_MAIN(TestBufferPool)
+#include "tst_bufferpool.moc"
@@ -0,0 +1,8 @@
+QT       = core concurrent
+
+TARGET = tst_chunkcodec
+
+SOURCES += \
+    tst_chunkcodec.cpp
+
+include(../tests.pri)
@@ -0,0 +1,232 @@
+#include <QTest>
+#include <QtEndian>
+#include "checksum.h"
+#include "chunkcodec.h"
+#include "testdata.h"
+
+namespace {
+
+using TestData::key;
+
+const qsizetype streamDataOffset = ChunkFormat::headerSize + ChunkFormat::frameHeaderSize;
+
+// Compressible, but not so regular that every frame comes out the same.
+QByteArray sampleData(qsizetype size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    quint32 state = 12345;
+    for (qsizetype i = 0; i != size; ++i) {
+        state = state * 1103515245 + 12345;
+        data[i] = static_cast<char>('a' + (state >> 16) % 8);
+    }
+    return data;
+}
+
+QByteArray encode(const QByteArray& data, const CompressionOptions& options, qsizetype pieceSize)
+{
+    QByteArray stream;
+    ChunkEncoder encoder(options, key, [&stream](const char* bytes, qint64 size) {
+        stream.append(bytes, size);
+        return true;
+    });
+
+    for (qsizetype position = 0; position < data.size(); position += pieceSize) {
+        if (!encoder.write(data.constData() + position, qMin(pieceSize, data.size() - position))) {
+            return QByteArray();
+        }
+    }
+    if (!encoder.finish()) {
+        return QByteArray();
+    }
+    return stream;
+}
+
+// Feeds the stream in pieces; returns false with errorString set as soon as
+// the decoder rejects it.
+bool decode(const QByteArray& stream, qsizetype pieceSize, QByteArray* data, QString* errorString)
+{
+    data->clear();
+    ChunkDecoder decoder(key, [data](const char* bytes, qint64 size) {
+        data->append(bytes, size);
+        return true;
+    });
+
+    bool isDecoded = true;
+    for (qsizetype position = 0; isDecoded && position < stream.size(); position += pieceSize) {
+        isDecoded = decoder.write(stream.constData() + position, qMin(pieceSize, stream.size() - position));
+    }
+    isDecoded = isDecoded && decoder.finish();
+    *errorString = decoder.errorString();
+    return isDecoded;
+}
+
+CompressionOptions smallChunks(CompressionOptions::Order order = CompressionOptions::CompressThenXor)
+{
+    CompressionOptions options;
+    options.level = 6;
+    options.order = order;
+    options.chunkSize = 4096;
+    return options;
+}
+
+void writeUInt32(QByteArray& bytes, qsizetype position, quint32 value)
+{
+    qToLittleEndian(value, bytes.data() + position);
+}
+
+} // namespace
+
+class TestChunkCodec : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+    void smallBatchRoundTrip();
+    void compresses();
+    void rejectsCorruptPayload();
+    void rejectsOversizedFrame();
+    void rejectsBadChunkSize();
+    void rejectsBadMagic();
+    void rejectsTruncatedStream();
+    void rejectsMismatchedLengthPrefix();
+};
+
+void TestChunkCodec::roundTrip_data()
+{
+    QTest::addColumn<int>("order");
+    QTest::addColumn<qsizetype>("size");
+    QTest::addColumn<qsizetype>("pieceSize");
+
+    for (int order : { int(CompressionOptions::CompressThenXor), int(CompressionOptions::XorThenCompress) }) {
+        for (qsizetype size : { 0, 1, 4095, 4096, 4097, 300000 }) {
+            QTest::addRow("order %d, %lld bytes", order, qlonglong(size)) << order << size << qsizetype(1000);
+        }
+        QTest::addRow("order %d, byte by byte", order) << order << qsizetype(9000) << qsizetype(1);
+    }
+}
+
+void TestChunkCodec::roundTrip()
+{
+    QFETCH(int, order);
+    QFETCH(qsizetype, size);
+    QFETCH(qsizetype, pieceSize);
+
+    const QByteArray original = sampleData(size);
+    const QByteArray stream = encode(original, smallChunks(static_cast<CompressionOptions::Order>(order)), pieceSize);
+    QVERIFY(stream.size() >= ChunkFormat::headerSize);
+
+    QByteArray decoded;
+    QString errorString;
+    QVERIFY2(decode(stream, pieceSize, &decoded, &errorString), qPrintable(errorString));
+    QCOMPARE(decoded, original);
+}
+
+void TestChunkCodec::smallBatchRoundTrip()
+{
+    CompressionOptions options = smallChunks();
+    options.maxBatchSize = 1;
+    QCOMPARE(ChunkEncoder::batchSize(options), 1);
+    QCOMPARE(ChunkEncoder::memoryFootprint(options), qint64(4 * 4096));
+
+    const QByteArray original = sampleData(100000);
+    QByteArray decoded;
+    QString errorString;
+    QVERIFY2(decode(encode(original, options, 65536), 65536, &decoded, &errorString), qPrintable(errorString));
+    QCOMPARE(decoded, original);
+}
+
+void TestChunkCodec::compresses()
+{
+    const QByteArray original(1024 * 1024, 'x');
+    const QByteArray stream = encode(original, smallChunks(), 65536);
+    QVERIFY(stream.size() < original.size() / 10);
+
+    // The key is applied: the stored bytes are not the plain zlib output.
+    QVERIFY(!stream.contains(qCompress(QByteArray(4096, 'x'), 6).mid(4, 16)));
+}
+
+void TestChunkCodec::rejectsCorruptPayload()
+{
+    QByteArray stream = encode(sampleData(20000), smallChunks(), 20000);
+    stream[streamDataOffset + 5] = static_cast<char>(stream.at(streamDataOffset + 5) ^ 0x01);
+
+    QByteArray decoded;
+    QString errorString;
+    QVERIFY(!decode(stream, stream.size(), &decoded, &errorString));
+    QVERIFY(!errorString.isEmpty());
+}
+
+void TestChunkCodec::rejectsOversizedFrame()
+{
+    // Only the frame header is supplied: a decoder that trusted the sizes
+    // would wait for gigabytes before noticing anything.
+    const QByteArray header = encode(QByteArray(), smallChunks(), 1);
+    QCOMPARE(header.size(), qsizetype(ChunkFormat::headerSize));
+
+    for (const auto& sizes : { std::pair<quint32, quint32>(4097, 100), std::pair<quint32, quint32>(100, 0x7FFFFFFF) }) {
+        QByteArray stream = header;
+        stream.append(ChunkFormat::frameHeaderSize, '\0');
+        writeUInt32(stream, ChunkFormat::headerSize, sizes.first);
+        writeUInt32(stream, ChunkFormat::headerSize + 4, sizes.second);
+
+        ChunkDecoder decoder(key, [](const char*, qint64) { return true; });
+        QVERIFY(!decoder.write(stream.constData(), stream.size()));
+        QVERIFY(!decoder.errorString().isEmpty());
+    }
+}
+
+void TestChunkCodec::rejectsBadChunkSize()
+{
+    for (quint32 chunkSize : { quint32(0), quint32(ChunkFormat::minChunkSize - 1), quint32(ChunkFormat::maxChunkSize + 1) }) {
+        QByteArray stream = encode(sampleData(100), smallChunks(), 100);
+        writeUInt32(stream, 8, chunkSize);
+
+        QByteArray decoded;
+        QString errorString;
+        QVERIFY(!decode(stream, stream.size(), &decoded, &errorString));
+        QVERIFY(decoded.isEmpty());
+    }
+}
+
+void TestChunkCodec::rejectsBadMagic()
+{
+    QByteArray stream = encode(sampleData(100), smallChunks(), 100);
+    stream[0] = 'Y';
+
+    QByteArray decoded;
+    QString errorString;
+    QVERIFY(!decode(stream, stream.size(), &decoded, &errorString));
+}
+
+void TestChunkCodec::rejectsTruncatedStream()
+{
+    const QByteArray stream = encode(sampleData(20000), smallChunks(), 20000);
+
+    QByteArray decoded;
+    QString errorString;
+    QVERIFY(!decode(stream.left(stream.size() - 1), 1000, &decoded, &errorString));
+    QVERIFY(!decode(stream.left(ChunkFormat::headerSize - 1), 1000, &decoded, &errorString));
+}
+
+void TestChunkCodec::rejectsMismatchedLengthPrefix()
+{
+    // With XorThenCompress the stored bytes are zlib output as is, so the
+    // qUncompress length prefix can be changed and the CRC fixed up.
+    QByteArray stream = encode(QByteArray(4096, 'x'), smallChunks(CompressionOptions::XorThenCompress), 4096);
+    const quint32 storedSize = qFromLittleEndian<quint32>(stream.constData() + ChunkFormat::headerSize + 4);
+    QVERIFY(!(storedSize & ChunkFormat::storedRawFlag));
+
+    qToBigEndian(quint32(0x7FFFFFFF), stream.data() + streamDataOffset);
+    writeUInt32(stream, ChunkFormat::headerSize + 8,
+                Crc32::update(0, stream.constData() + streamDataOffset, storedSize));
+
+    QByteArray decoded;
+    QString errorString;
+    QVERIFY(!decode(stream, stream.size(), &decoded, &errorString));
+    QVERIFY(decoded.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestChunkCodec)
+#include "tst_chunkcodec.moc"
@@ -0,0 +1,8 @@
+QT       = core
+
+TARGET = tst_cputopology
+
+SOURCES += \
+    tst_cputopology.cpp
+
+include(../tests.pri)
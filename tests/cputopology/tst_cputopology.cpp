@@ -0,0 +1,84 @@
+#include <QTest>
+#include "cputopology.h"
+
+class TestCpuTopology : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseAndFormat_data();
+    void parseAndFormat();
+    void rejects_data();
+    void rejects();
+    void nodesCoverSomeCpus();
+};
+
+void TestCpuTopology::parseAndFormat_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QList<int>>("cpus");
+    QTest::addColumn<QString>("formatted");
+
+    QTest::newRow("empty") << QString() << QList<int>() << QString();
+    QTest::newRow("single") << "3" << QList<int>{ 3 } << "3";
+    QTest::newRow("ranges") << "0-3,8,10-11" << QList<int>{ 0, 1, 2, 3, 8, 10, 11 } << "0-3,8,10-11";
+    QTest::newRow("unsorted, overlapping") << " 10-11, 0-2 ,1-3,8" << QList<int>{ 0, 1, 2, 3, 8, 10, 11 }
+                                           << "0-3,8,10-11";
+    QTest::newRow("adjacent ranges merge") << "0-1,2-3" << QList<int>{ 0, 1, 2, 3 } << "0-3";
+    QTest::newRow("sysfs newline") << "0-1\n" << QList<int>{ 0, 1 } << "0-1";
+    QTest::newRow("highest id") << QString("%1").arg(CpuTopology::maxCpuCount - 1)
+                                << QList<int>{ CpuTopology::maxCpuCount - 1 }
+                                << QString::number(CpuTopology::maxCpuCount - 1);
+}
+
+void TestCpuTopology::parseAndFormat()
+{
+    QFETCH(QString, text);
+    QFETCH(QList<int>, cpus);
+    QFETCH(QString, formatted);
+
+    QList<int> parsed = { -1 };
+    QVERIFY(CpuTopology::parseCpuList(text, &parsed));
+    QCOMPARE(parsed, cpus);
+    QCOMPARE(CpuTopology::formatCpuList(parsed), formatted);
+
+    QList<int> reparsed;
+    QVERIFY(CpuTopology::parseCpuList(formatted, &reparsed));
+    QCOMPARE(reparsed, cpus);
+}
+
+void TestCpuTopology::rejects_data()
+{
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("not a number") << "a";
+    QTest::newRow("negative") << "-1";
+    QTest::newRow("inverted range") << "3-1";
+    QTest::newRow("open range") << "3-";
+    QTest::newRow("three bounds") << "1-2-3";
+    QTest::newRow("id past cpu set") << QString::number(CpuTopology::maxCpuCount);
+    QTest::newRow("huge range") << "0-2000000000";
+    QTest::newRow("overflow") << "0-99999999999";
+    QTest::newRow("bad part after good") << "0-3,x";
+}
+
+void TestCpuTopology::rejects()
+{
+    QFETCH(QString, text);
+
+    QList<int> cpus = { 7 };
+    QVERIFY(!CpuTopology::parseCpuList(text, &cpus));
+    QCOMPARE(cpus, QList<int>{ 7 });
+}
+
+void TestCpuTopology::nodesCoverSomeCpus()
+{
+    const QList<CpuTopology::Node> nodes = CpuTopology::nodes();
+    QVERIFY(!nodes.isEmpty());
+    for (const CpuTopology::Node& node : nodes) {
+        QVERIFY(!node.cpus.isEmpty());
+    }
+}
+
+QTEST_GUILESS_MAIN(TestCpuTopology)
+#include "tst_cputopology.moc"
@@ -0,0 +1,16 @@
+QT       = core gui concurrent
+
+TARGET = tst_filelistmodel
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_filelistmodel.cpp \
+    ../../filelistmodel.cpp \
+    ../../fileutils.cpp
+
+HEADERS += \
+    ../../filelistmodel.h \
+    ../../fileutils.h
+
+include(../tests.pri)
@@ -0,0 +1,199 @@
+#include <QAbstractItemModelTester>
+#include <QTest>
+#include "filelistmodel.h"
+
+#include <algorithm>
+
+namespace {
+
+// FileListModel::maxFiles: past it the oldest quarter of the list is dropped.
+const int maxFiles = 100000;
+
+QStringList displayedNames(const FileListModel& model)
+{
+    QStringList names;
+    for (int row = 0; row != model.rowCount(); ++row) {
+        names.append(model.data(model.index(row)).toString().section(" -> ", 0, 0));
+    }
+    return names;
+}
+
+} // namespace
+
+class TestFileListModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void publishesAppendedFiles();
+    void filterAndSortByDuration();
+    void persistentIndexFollowsReorder();
+    void dropsOldestFiles();
+    void dropsOldestFilesFromCustomView();
+    void clearWhileViewIsComputed();
+};
+
+void TestFileListModel::publishesAppendedFiles()
+{
+    FileListModel model;
+    QAbstractItemModelTester tester(&model);
+
+    QCOMPARE(model.addFile("/in", "a.bin", "a.bin", 10), 0);
+    QCOMPARE(model.addFile("/in", "b.bin", "b (1).bin", 20), 1);
+    QTRY_COMPARE(model.rowCount(), 2);
+
+    QCOMPARE(model.data(model.index(1)).toString(), QString("b.bin -> b (1).bin"));
+    QVERIFY(model.data(model.index(0), Qt::ToolTipRole).toString().startsWith("/in/a.bin"));
+}
+
+void TestFileListModel::filterAndSortByDuration()
+{
+    FileListModel model;
+    QAbstractItemModelTester tester(&model);
+
+    QHash<QString, qint64> durations;
+    QList<int> fileIds;
+    for (int i = 0; i != 40; ++i) {
+        const QString name = QString(i % 2 ? "other-%1.dat" : "file-%1.bin").arg(i);
+        fileIds.append(model.addFile("/in", name, name, i));
+    }
+
+    model.setFilterText("file");
+    model.setSortKey(FileListModel::ByDuration);
+
+    // Re-times files while the view is shown, then adds more: both have to be
+    // merged into the order without a recompute.
+    for (int i = 0; i != 40; ++i) {
+        const qint64 durationUs = (i * 7919) % 53 * 1000;
+        model.setStatus(fileIds.at(i), FileListModel::Done, durationUs);
+        durations.insert(QString(i % 2 ? "other-%1.dat" : "file-%1.bin").arg(i), durationUs);
+    }
+
+    const auto expectedNames = [&durations]() {
+        QStringList names;
+        for (auto it = durations.cbegin(); it != durations.cend(); ++it) {
+            if (it.key().contains("file")) {
+                names.append(it.key());
+            }
+        }
+        // Longest first, ties by arrival (the number in the name).
+        std::sort(names.begin(), names.end(), [&durations](const QString& left, const QString& right) {
+            if (durations.value(left) != durations.value(right)) {
+                return durations.value(left) > durations.value(right);
+            }
+            return left.section('-', 1).section('.', 0, 0).toInt() < right.section('-', 1).section('.', 0, 0).toInt();
+        });
+        return names;
+    };
+    QTRY_COMPARE(displayedNames(model), expectedNames());
+
+    for (int i = 40; i != 60; ++i) {
+        const QString name = QString(i % 2 ? "other-%1.dat" : "file-%1.bin").arg(i);
+        const qint64 durationUs = (i * 104729) % 61 * 1000;
+        model.setStatus(model.addFile("/in", name, name, i), FileListModel::Done, durationUs);
+        durations.insert(name, durationUs);
+    }
+    model.setStatus(fileIds.at(0), FileListModel::Done, 1000000);
+    durations.insert("file-0.bin", 1000000);
+    QTRY_COMPARE(displayedNames(model), expectedNames());
+
+    model.setFilterText("other-5.");
+    QTRY_COMPARE(displayedNames(model), QStringList() << "other-5.dat");
+
+    model.setFilterText(QString());
+    model.setSortKey(FileListModel::ByArrival);
+    QTRY_COMPARE(model.rowCount(), 60);
+    QCOMPARE(displayedNames(model).first(), QString("file-0.bin"));
+}
+
+void TestFileListModel::persistentIndexFollowsReorder()
+{
+    FileListModel model;
+    QAbstractItemModelTester tester(&model);
+
+    QList<int> fileIds;
+    for (int i = 0; i != 10; ++i) {
+        fileIds.append(model.addFile("/in", QString("file-%1.bin").arg(i), QString("file-%1.bin").arg(i), i));
+    }
+    model.setStatus(fileIds.at(3), FileListModel::Done, 2000);
+    model.setSortKey(FileListModel::ByDuration);
+    QTRY_COMPARE(displayedNames(model).first(), QString("file-3.bin"));
+
+    const QPersistentModelIndex selected = model.index(4);
+    const QString selectedName = model.data(selected).toString();
+
+    model.setStatus(fileIds.at(9), FileListModel::Done, 5000);
+    QTRY_COMPARE(displayedNames(model).first(), QString("file-9.bin"));
+
+    QCOMPARE(selected.row(), 5);
+    QCOMPARE(model.data(selected).toString(), selectedName);
+}
+
+void TestFileListModel::dropsOldestFiles()
+{
+    FileListModel model;
+    QAbstractItemModelTester tester(&model);
+
+    int lastFileId = -1;
+    for (int i = 0; i <= maxFiles; ++i) {
+        lastFileId = model.addFile("/in", QString("f%1").arg(i), QString("f%1").arg(i), i);
+    }
+    QCOMPARE(lastFileId, maxFiles);
+
+    const int droppedCount = maxFiles + 1 - maxFiles * 3 / 4;
+    QTRY_COMPARE(model.rowCount(), maxFiles * 3 / 4);
+    QCOMPARE(model.data(model.index(0)).toString(), QString("f%1 -> f%1").arg(droppedCount));
+
+    // Ids keep counting after the drop; ids of dropped files are ignored.
+    model.setStatus(0, FileListModel::Failed);
+    model.setStatus(lastFileId, FileListModel::Failed);
+    QCOMPARE(model.addFile("/in", "next", "next", 0), maxFiles + 1);
+    QTRY_COMPARE(model.rowCount(), maxFiles * 3 / 4 + 1);
+    QVERIFY(!model.data(model.index(0), Qt::ForegroundRole).isValid());
+    QVERIFY(model.data(model.index(model.rowCount() - 2), Qt::ForegroundRole).isValid());
+}
+
+void TestFileListModel::dropsOldestFilesFromCustomView()
+{
+    FileListModel model;
+    QAbstractItemModelTester tester(&model);
+
+    for (int i = 0; i != maxFiles; ++i) {
+        model.addFile("/in", QString("f%1").arg(i), QString("f%1").arg(i), i);
+    }
+    model.setFilterText("f9999");
+    QTRY_COMPARE(displayedNames(model), QStringList() << "f9999" << "f99990" << "f99991" << "f99992"
+                                                      << "f99993" << "f99994" << "f99995" << "f99996"
+                                                      << "f99997" << "f99998" << "f99999");
+
+    model.addFile("/in", "f99990x", "f99990x", 0);
+    QTRY_COMPARE(displayedNames(model), QStringList() << "f99990" << "f99991" << "f99992" << "f99993"
+                                                      << "f99994" << "f99995" << "f99996" << "f99997"
+                                                      << "f99998" << "f99999" << "f99990x");
+}
+
+void TestFileListModel::clearWhileViewIsComputed()
+{
+    FileListModel model;
+    QAbstractItemModelTester tester(&model);
+
+    for (int i = 0; i != 50000; ++i) {
+        model.addFile("/in", QString("old-%1").arg(i), QString("old-%1").arg(i), i);
+    }
+    QTRY_COMPARE(model.rowCount(), 50000);
+
+    // The clear lands while the sort runs on the pool: its result indexes
+    // the old columns and must not be shown.
+    model.setSortKey(FileListModel::ByName);
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+
+    model.addFile("/in", "b", "b", 0);
+    model.addFile("/in", "a", "a", 0);
+    QTRY_COMPARE(displayedNames(model), QStringList() << "a" << "b");
+    QTest::qWait(200);
+    QCOMPARE(displayedNames(model), QStringList() << "a" << "b");
+}
+
+QTEST_GUILESS_MAIN(TestFileListModel)
+#include "tst_filelistmodel.moc"
@@ -0,0 +1,14 @@
+QT       = core
+
+TARGET = tst_filequeue
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_filequeue.cpp \
+    ../../filequeue.cpp
+
+HEADERS += \
+    ../../filequeue.h
+
+include(../tests.pri)
@@ -0,0 +1,147 @@
+#include <QTest>
+#include "filequeue.h"
+
+namespace {
+
+const qint64 megabyte = 1024 * 1024;
+const qint64 second = 1000000000; // ns
+
+QStringList takeAll(FileQueue& queue, bool isSmallFileLane = false)
+{
+    QStringList filePaths;
+    while (!queue.isEmpty()) {
+        filePaths.append(queue.takeNext(isSmallFileLane).filePath);
+    }
+    return filePaths;
+}
+
+} // namespace
+
+class TestFileQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fifoKeepsArrivalOrder();
+    void shortestFirst();
+    void largestFirst();
+    void largestFirstSmallFileLane();
+    void agingScore();
+    void setPolicyReorders();
+    void capacity();
+};
+
+void TestFileQueue::fifoKeepsArrivalOrder()
+{
+    FileQueue queue(SchedulingPolicy::Fifo);
+    queue.push("c", 30, 0);
+    queue.push("a", 10, 0);
+    queue.push("b", 20, 0);
+    queue.push("a", 99, 0);
+
+    QCOMPARE(queue.size(), 3);
+    QVERIFY(queue.contains("a"));
+
+    const FileQueue::Entry entry = queue.takeNext();
+    QCOMPARE(entry.filePath, QString("c"));
+    QCOMPARE(entry.size, qint64(30));
+    QVERIFY(!queue.contains("c"));
+
+    QCOMPARE(takeAll(queue), QStringList() << "a" << "b");
+    QVERIFY(queue.takeNext().filePath.isEmpty());
+}
+
+void TestFileQueue::shortestFirst()
+{
+    FileQueue queue(SchedulingPolicy::ShortestFirst);
+    queue.push("large", 300, 0);
+    queue.push("small-1", 100, 0);
+    queue.push("medium", 200, 0);
+    queue.push("small-2", 100, 0);
+
+    // Equal sizes keep their arrival order.
+    QCOMPARE(takeAll(queue), QStringList() << "small-1" << "small-2" << "medium" << "large");
+}
+
+void TestFileQueue::largestFirst()
+{
+    FileQueue queue(SchedulingPolicy::LargestFirst);
+    queue.push("small", 100, 0);
+    queue.push("large-1", 300, 0);
+    queue.push("medium", 200, 0);
+    queue.push("large-2", 300, 0);
+
+    QCOMPARE(takeAll(queue), QStringList() << "large-1" << "large-2" << "medium" << "small");
+}
+
+void TestFileQueue::largestFirstSmallFileLane()
+{
+    FileQueue queue(SchedulingPolicy::LargestFirst);
+    queue.push("small", 100, 0);
+    queue.push("large", 300, 0);
+    queue.push("medium", 200, 0);
+
+    // The small-file lane (worker 0) takes from the other end, so small files
+    // do not wait behind every large one.
+    QCOMPARE(queue.takeNext(true).filePath, QString("small"));
+    QCOMPARE(queue.takeNext(false).filePath, QString("large"));
+    QCOMPARE(queue.takeNext(true).filePath, QString("medium"));
+    QVERIFY(queue.isEmpty());
+
+    // Other policies ignore the lane.
+    FileQueue shortestFirst(SchedulingPolicy::ShortestFirst);
+    shortestFirst.push("large", 300, 0);
+    shortestFirst.push("small", 100, 0);
+    QCOMPARE(shortestFirst.takeNext(false).filePath, QString("small"));
+}
+
+void TestFileQueue::agingScore()
+{
+    // Every second of waiting is worth agingBytesPerSecond (64 MiB) of size.
+    QCOMPARE(FileQueue::agingBytesPerSecond, 64.0 * megabyte);
+
+    FileQueue queue(SchedulingPolicy::Aging);
+    queue.push("large-early", 100 * megabyte, 0);
+    queue.push("small-later", 1 * megabyte, 1 * second);   // 65 MiB
+    queue.push("small-latest", 1 * megabyte, 2 * second);  // 129 MiB
+    queue.push("medium-later", 30 * megabyte, 1 * second); // 94 MiB
+
+    QCOMPARE(takeAll(queue), QStringList() << "small-later" << "medium-later" << "large-early" << "small-latest");
+}
+
+void TestFileQueue::setPolicyReorders()
+{
+    FileQueue queue(SchedulingPolicy::Fifo);
+    queue.push("large", 300, 0);
+    queue.push("small", 100, 0);
+    queue.push("medium", 200, 0);
+
+    queue.setPolicy(SchedulingPolicy::ShortestFirst);
+    QVERIFY(queue.policy() == SchedulingPolicy::ShortestFirst);
+    QCOMPARE(queue.takeNext().filePath, QString("small"));
+
+    queue.setPolicy(SchedulingPolicy::Fifo);
+    QCOMPARE(takeAll(queue), QStringList() << "large" << "medium");
+}
+
+void TestFileQueue::capacity()
+{
+    FileQueue queue;
+    queue.push("a", 1, 0);
+    QVERIFY(!queue.isFull());
+
+    queue.setCapacity(2);
+    queue.push("b", 1, 0);
+    QVERIFY(queue.isFull());
+
+    // Advisory only: pushing past it still works.
+    queue.push("c", 1, 0);
+    QCOMPARE(queue.size(), 3);
+
+    queue.clear();
+    QVERIFY(queue.isEmpty());
+    QVERIFY(!queue.contains("a"));
+}
+
+QTEST_GUILESS_MAIN(TestFileQueue)
+#include "tst_filequeue.moc"
@@ -0,0 +1,15 @@
+QT       = core
+
+TARGET = tst_logger
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_logger.cpp \
+    ../../logger.cpp
+
+HEADERS += \
+    ../../logger.h \
+    ../../ringbuffer.h
+
+include(../tests.pri)
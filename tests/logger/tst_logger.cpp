@@ -0,0 +1,260 @@
+#include <QSignalSpy>
+#include <QTest>
+#include <QThread>
+#include "logger.h"
+#include "ringbuffer.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Logger's ring buffer capacity: past it entries are dropped and counted.
+const int queueCapacity = 64 * 1024;
+
+struct Batch
+{
+    QStringList lines;
+    quint64 generation = 0;
+};
+
+QList<Batch> batches(const QSignalSpy& spy)
+{
+    QList<Batch> result;
+    for (const QList<QVariant>& arguments : spy) {
+        result.append({ arguments.at(0).toStringList(), arguments.at(1).toULongLong() });
+    }
+    return result;
+}
+
+QStringList allLines(const QSignalSpy& spy)
+{
+    QStringList lines;
+    for (const Batch& batch : batches(spy)) {
+        lines += batch.lines;
+    }
+    return lines;
+}
+
+// Strips the "[hh:mm:ss] " timestamp.
+QString messageOf(const QString& line)
+{
+    return line.section("] ", 1);
+}
+
+} // namespace
+
+class TestLogger : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void ringBufferIsBounded();
+    void ringBufferConcurrentProducersAndConsumers();
+    void concurrentProducers();
+    void overflowReportsDroppedCount();
+    void batchIsCutAtGenerationChange();
+    void droppedCountGoesToCurrentGeneration();
+    void minimumLevel();
+};
+
+void TestLogger::ringBufferIsBounded()
+{
+    RingBuffer<int> ring(8);
+    QCOMPARE(ring.capacity(), std::size_t(8));
+
+    // Several rounds, so positions wrap around the cells.
+    int value = 0;
+    for (int round = 0; round != 5; ++round) {
+        for (int i = 0; i != 8; ++i) {
+            QVERIFY(ring.tryPush(round * 8 + i));
+        }
+        QVERIFY(!ring.tryPush(-1));
+
+        for (int i = 0; i != 8; ++i) {
+            QVERIFY(ring.tryPop(value));
+            QCOMPARE(value, round * 8 + i);
+        }
+        QVERIFY(!ring.tryPop(value));
+    }
+}
+
+void TestLogger::ringBufferConcurrentProducersAndConsumers()
+{
+    const int producerCount = 4;
+    const int consumerCount = 4;
+    const int valuesPerProducer = 100000;
+    const int total = producerCount * valuesPerProducer;
+
+    RingBuffer<int> ring(1024);
+    std::vector<std::atomic<int>> received(total);
+    std::atomic<int> poppedCount { 0 };
+    std::atomic<bool> isOrdered { true };
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int producer = 0; producer != producerCount; ++producer) {
+        threads.emplace_back(QThread::create([&ring, producer, valuesPerProducer]() {
+            for (int i = 0; i != valuesPerProducer;) {
+                if (ring.tryPush(producer * valuesPerProducer + i)) {
+                    ++i;
+                }
+            }
+        }));
+    }
+    for (int consumer = 0; consumer != consumerCount; ++consumer) {
+        threads.emplace_back(QThread::create([&, producerCount]() {
+            // Each consumer sees every producer's values in push order.
+            std::vector<int> last(producerCount, -1);
+            int value = 0;
+            while (poppedCount.load() < total) {
+                if (!ring.tryPop(value)) {
+                    continue;
+                }
+                received[value].fetch_add(1);
+                const int producer = value / valuesPerProducer;
+                if (value <= last[producer]) {
+                    isOrdered = false;
+                }
+                last[producer] = value;
+                poppedCount.fetch_add(1);
+            }
+        }));
+    }
+
+    for (const auto& thread : threads) {
+        thread->start();
+    }
+    for (const auto& thread : threads) {
+        QVERIFY(thread->wait(60000));
+    }
+
+    QVERIFY(isOrdered);
+    for (int value = 0; value != total; ++value) {
+        QCOMPARE(received[value].load(), 1);
+    }
+}
+
+void TestLogger::concurrentProducers()
+{
+    const int producerCount = 4;
+    const int messagesPerProducer = 10000;
+
+    Logger logger;
+    QSignalSpy spy(&logger, &Logger::messagesReady);
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int producer = 0; producer != producerCount; ++producer) {
+        threads.emplace_back(QThread::create([&logger, producer, messagesPerProducer]() {
+            for (int i = 0; i != messagesPerProducer; ++i) {
+                logger.log(LogLevel::Info, QString("%1:%2").arg(producer).arg(i));
+            }
+        }));
+        threads.back()->start();
+    }
+    for (const auto& thread : threads) {
+        QVERIFY(thread->wait(60000));
+    }
+    logger.stop();
+
+    const QStringList lines = allLines(spy);
+    QCOMPARE(lines.size(), producerCount * messagesPerProducer);
+
+    QList<int> next(producerCount, 0);
+    for (const QString& line : lines) {
+        const QString message = messageOf(line);
+        const int producer = message.section(':', 0, 0).toInt();
+        QCOMPARE(message.section(':', 1).toInt(), next[producer]);
+        ++next[producer];
+    }
+}
+
+void TestLogger::overflowReportsDroppedCount()
+{
+    Logger logger;
+    QSignalSpy spy(&logger, &Logger::messagesReady);
+
+    const int droppedCount = 1234;
+    for (int i = 0; i != queueCapacity + droppedCount; ++i) {
+        logger.log(LogLevel::Info, QString::number(i));
+    }
+    logger.stop();
+
+    const QStringList lines = allLines(spy);
+    QCOMPARE(lines.size(), queueCapacity + 1);
+    QCOMPARE(messageOf(lines.at(queueCapacity - 1)), QString::number(queueCapacity - 1));
+    QCOMPARE(messageOf(lines.last()),
+             QString("WARN log queue overflow: %1 message(s) dropped").arg(droppedCount));
+
+    // The count is reset once reported.
+    spy.clear();
+    logger.log(LogLevel::Info, "after");
+    logger.stop();
+    QCOMPARE(allLines(spy).size(), 1);
+}
+
+void TestLogger::batchIsCutAtGenerationChange()
+{
+    Logger logger;
+    QSignalSpy spy(&logger, &Logger::messagesReady);
+
+    logger.log(LogLevel::Info, "a");
+    logger.log(LogLevel::Info, "b");
+    const quint64 generation = logger.startGeneration();
+    logger.log(LogLevel::Info, "c");
+    QCOMPARE(logger.startGeneration(), generation + 1);
+    logger.log(LogLevel::Info, "d");
+    logger.stop();
+
+    const QList<Batch> result = batches(spy);
+    QCOMPARE(result.size(), 3);
+    QCOMPARE(result.at(0).generation, generation - 1);
+    QCOMPARE(result.at(0).lines.size(), 2);
+    QCOMPARE(messageOf(result.at(0).lines.at(1)), QString("b"));
+    QCOMPARE(result.at(1).generation, generation);
+    QCOMPARE(messageOf(result.at(1).lines.at(0)), QString("c"));
+    QCOMPARE(result.at(2).generation, generation + 1);
+    QCOMPARE(messageOf(result.at(2).lines.at(0)), QString("d"));
+}
+
+void TestLogger::droppedCountGoesToCurrentGeneration()
+{
+    Logger logger;
+    QSignalSpy spy(&logger, &Logger::messagesReady);
+
+    for (int i = 0; i != queueCapacity + 1; ++i) {
+        logger.log(LogLevel::Info, QString::number(i));
+    }
+    const quint64 generation = logger.startGeneration();
+    logger.stop();
+
+    const QList<Batch> result = batches(spy);
+    QCOMPARE(result.size(), 2);
+    QCOMPARE(result.at(0).lines.size(), queueCapacity);
+    QCOMPARE(result.at(1).generation, generation);
+    QCOMPARE(result.at(1).lines.size(), 1);
+    QVERIFY(result.at(1).lines.at(0).contains("1 message(s) dropped"));
+}
+
+void TestLogger::minimumLevel()
+{
+    Logger logger;
+    QSignalSpy spy(&logger, &Logger::messagesReady);
+
+    logger.setMinimumLevel(LogLevel::Warning);
+    QVERIFY(!logger.isEnabled(LogLevel::Info));
+    logger.log(LogLevel::Info, "skipped");
+    logger.log(LogLevel::Error, "kept");
+    logger.stop();
+
+    QCOMPARE(allLines(spy).size(), 1);
+    QCOMPARE(messageOf(allLines(spy).first()), QString("ERROR kept"));
+
+    LogLevel level = LogLevel::Debug;
+    QVERIFY(Logger::parseLevel(" Warning ", &level));
+    QVERIFY(level == LogLevel::Warning);
+    QVERIFY(!Logger::parseLevel("verbose", &level));
+}
+
+QTEST_GUILESS_MAIN(TestLogger)
+#include "tst_logger.moc"
@@ -0,0 +1,8 @@
+QT       = core concurrent
+
+TARGET = tst_segments
+
+SOURCES += \
+    tst_segments.cpp
+
+include(../tests.pri)
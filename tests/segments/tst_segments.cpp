@@ -0,0 +1,371 @@
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+#include "chunkcodec.h"
+#include "segmentreader.h"
+#include "segmentwriter.h"
+#include "testdata.h"
+#include "xorcodec.h"
+
+#include <limits>
+
+namespace {
+
+using TestData::key;
+using TestData::patternData;
+const QDateTime modified = QDateTime::fromSecsSinceEpoch(1700000000);
+
+// Stores the payload the way the worker does: XORed from key phase 0.
+bool addEntry(SegmentWriter& writer, const QString& name, QByteArray data)
+{
+    XorCodec::apply(data, key, 0);
+    return writer.beginEntry(name, modified)
+        && writer.write(data.constData(), data.size())
+        && writer.commitEntry();
+}
+
+bool addCompressedEntry(SegmentWriter& writer, const QString& name, const QByteArray& data)
+{
+    CompressionOptions options;
+    options.level = 6;
+    options.chunkSize = 4096;
+
+    if (!writer.beginEntry(name, modified, SegmentEntry::Compressed)) {
+        return false;
+    }
+    ChunkEncoder encoder(options, key, [&writer](const char* bytes, qint64 size) {
+        return writer.write(bytes, size);
+    });
+    return encoder.write(data.constData(), data.size()) && encoder.finish() && writer.commitEntry();
+}
+
+bool flipByte(const QString& filePath, qint64 offset)
+{
+    QFile file(filePath);
+    char byte = 0;
+    if (!file.open(QIODevice::ReadWrite) || !file.seek(offset) || !file.getChar(&byte)) {
+        return false;
+    }
+    return file.seek(offset) && file.putChar(static_cast<char>(byte ^ 0x01));
+}
+
+} // namespace
+
+class TestSegments : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip();
+    void compressedRoundTrip();
+    void durableRoundTrip();
+    void extractWritesFile();
+    void abortedEntryIsInvisible();
+    void laterEntryWins();
+    void reopenStartsNewSegment();
+    void truncatedIndexRecordIsIgnored();
+    void rejectsCorruptPayload();
+    void rejectsCorruptCompressedPayload();
+    void rejectsBadIndexHeader();
+    void ignoresEntriesOutsideDataFile();
+};
+
+void TestSegments::roundTrip()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    // A small segment limit spreads the entries over several segments.
+    QList<QByteArray> originals;
+    SegmentWriter writer;
+    QVERIFY(writer.open(directory.path(), 50000));
+    for (int i = 0; i != 8; ++i) {
+        originals.append(patternData(i * 9001, i));
+        QVERIFY(addEntry(writer, QString("file-%1.bin").arg(i), originals.last()));
+    }
+    writer.close();
+
+    SegmentReader reader;
+    QString errorMessage;
+    QVERIFY2(reader.open(directory.path(), &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(reader.entryNames().size(), originals.size());
+    QVERIFY(reader.entry("file-7.bin").segmentNumber > 1);
+
+    for (int i = 0; i != originals.size(); ++i) {
+        const QString name = QString("file-%1.bin").arg(i);
+        QCOMPARE(reader.entry(name).modifiedMs, modified.toMSecsSinceEpoch());
+
+        QByteArray data;
+        QVERIFY2(reader.read(name, &data, key, &errorMessage), qPrintable(errorMessage));
+        QCOMPARE(data, originals.at(i));
+    }
+}
+
+void TestSegments::compressedRoundTrip()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    const QByteArray original = QByteArray(100000, 'x') + patternData(5000);
+    SegmentWriter writer;
+    QVERIFY(writer.open(directory.path(), 1024 * 1024));
+    QVERIFY(addCompressedEntry(writer, "packed.bin", original));
+    writer.close();
+
+    SegmentReader reader;
+    QVERIFY(reader.open(directory.path()));
+    QVERIFY(reader.entry("packed.bin").flags & SegmentEntry::Compressed);
+    QVERIFY(reader.entry("packed.bin").length < original.size());
+
+    QByteArray data;
+    QString errorMessage;
+    QVERIFY2(reader.read("packed.bin", &data, key, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(data, original);
+}
+
+void TestSegments::durableRoundTrip()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    SegmentWriter writer;
+    QVERIFY(writer.open(directory.path(), 10000));
+    writer.setDurable(true);
+    for (int i = 0; i != 3; ++i) {
+        QVERIFY(addEntry(writer, QString("file-%1.bin").arg(i), patternData(8000, i)));
+    }
+    writer.close();
+
+    SegmentReader reader;
+    QVERIFY(reader.open(directory.path()));
+    for (int i = 0; i != 3; ++i) {
+        QByteArray data;
+        QVERIFY(reader.read(QString("file-%1.bin").arg(i), &data, key));
+        QCOMPARE(data, patternData(8000, i));
+    }
+}
+
+void TestSegments::extractWritesFile()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    const QByteArray original = patternData(70000);
+    SegmentWriter writer;
+    QVERIFY(writer.open(directory.path(), 1024 * 1024));
+    QVERIFY(addEntry(writer, "file.bin", original));
+    writer.close();
+
+    SegmentReader reader;
+    QVERIFY(reader.open(directory.path()));
+
+    const QString outputFilePath = directory.filePath("extracted.bin");
+    QString errorMessage;
+    QVERIFY2(reader.extract("file.bin", outputFilePath, key, &errorMessage), qPrintable(errorMessage));
+
+    QFile outputFile(outputFilePath);
+    QVERIFY(outputFile.open(QIODevice::ReadOnly));
+    QCOMPARE(outputFile.readAll(), original);
+    QCOMPARE(QFileInfo(outputFilePath).lastModified(), modified);
+}
+
+void TestSegments::abortedEntryIsInvisible()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    const QByteArray original = patternData(5000, 1);
+    SegmentWriter writer;
+    QVERIFY(writer.open(directory.path(), 1024 * 1024));
+
+    QVERIFY(writer.beginEntry("aborted.bin", modified));
+    const QByteArray garbage = patternData(30000, 2);
+    QVERIFY(writer.write(garbage.constData(), garbage.size()));
+    writer.abortEntry();
+
+    QVERIFY(addEntry(writer, "kept.bin", original));
+    writer.close();
+
+    SegmentReader reader;
+    QVERIFY(reader.open(directory.path()));
+    QVERIFY(!reader.contains("aborted.bin"));
+    QCOMPARE(reader.entry("kept.bin").offset, SegmentFormat::headerSize);
+
+    QByteArray data;
+    QVERIFY(reader.read("kept.bin", &data, key));
+    QCOMPARE(data, original);
+    QCOMPARE(QFileInfo(directory.filePath(SegmentFormat::dataFileName(1))).size(),
+             SegmentFormat::headerSize + original.size());
+}
+
+void TestSegments::laterEntryWins()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    SegmentWriter writer;
+    QVERIFY(writer.open(directory.path(), 1024 * 1024));
+    QVERIFY(addEntry(writer, "file.bin", patternData(100, 1)));
+    QVERIFY(addEntry(writer, "file.bin", patternData(200, 2)));
+    writer.close();
+
+    SegmentReader reader;
+    QVERIFY(reader.open(directory.path()));
+
+    QByteArray data;
+    QVERIFY(reader.read("file.bin", &data, key));
+    QCOMPARE(data, patternData(200, 2));
+}
+
+void TestSegments::reopenStartsNewSegment()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    for (int run = 0; run != 2; ++run) {
+        SegmentWriter writer;
+        QVERIFY(writer.open(directory.path(), 1024 * 1024));
+        QVERIFY(addEntry(writer, QString("run-%1.bin").arg(run), patternData(1000, run)));
+    }
+
+    SegmentReader reader;
+    QVERIFY(reader.open(directory.path()));
+    QCOMPARE(reader.entry("run-0.bin").segmentNumber, 1);
+    QCOMPARE(reader.entry("run-1.bin").segmentNumber, 2);
+
+    QByteArray data;
+    QVERIFY(reader.read("run-0.bin", &data, key));
+    QCOMPARE(data, patternData(1000, 0));
+}
+
+void TestSegments::truncatedIndexRecordIsIgnored()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    SegmentWriter writer;
+    QVERIFY(writer.open(directory.path(), 1024 * 1024));
+    QVERIFY(addEntry(writer, "first.bin", patternData(100, 1)));
+    QVERIFY(addEntry(writer, "second.bin", patternData(100, 2)));
+    writer.close();
+
+    QFile indexFile(directory.filePath(SegmentFormat::indexFileName(1)));
+    QVERIFY(indexFile.resize(indexFile.size() - 3));
+
+    SegmentReader reader;
+    QVERIFY(reader.open(directory.path()));
+    QVERIFY(reader.contains("first.bin"));
+    QVERIFY(!reader.contains("second.bin"));
+}
+
+void TestSegments::rejectsCorruptPayload()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    SegmentWriter writer;
+    QVERIFY(writer.open(directory.path(), 1024 * 1024));
+    QVERIFY(addEntry(writer, "file.bin", patternData(100000)));
+    writer.close();
+
+    QVERIFY(flipByte(directory.filePath(SegmentFormat::dataFileName(1)), SegmentFormat::headerSize + 99000));
+
+    SegmentReader reader;
+    QVERIFY(reader.open(directory.path()));
+
+    QByteArray data;
+    QString errorMessage;
+    QVERIFY(!reader.read("file.bin", &data, key, &errorMessage));
+    QVERIFY(data.isEmpty());
+    QVERIFY(!errorMessage.isEmpty());
+
+    const QString outputFilePath = directory.filePath("extracted.bin");
+    QVERIFY(!reader.extract("file.bin", outputFilePath, key));
+    QVERIFY(!QFile::exists(outputFilePath));
+}
+
+void TestSegments::rejectsCorruptCompressedPayload()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    SegmentWriter writer;
+    QVERIFY(writer.open(directory.path(), 1024 * 1024));
+    QVERIFY(addCompressedEntry(writer, "packed.bin", QByteArray(100000, 'x')));
+    writer.close();
+
+    const qint64 dataOffset = SegmentFormat::headerSize + ChunkFormat::headerSize + ChunkFormat::frameHeaderSize;
+    QVERIFY(flipByte(directory.filePath(SegmentFormat::dataFileName(1)), dataOffset + 2));
+
+    SegmentReader reader;
+    QVERIFY(reader.open(directory.path()));
+
+    QByteArray data;
+    QString errorMessage;
+    QVERIFY(!reader.read("packed.bin", &data, key, &errorMessage));
+    QVERIFY(data.isEmpty());
+    QVERIFY(!errorMessage.isEmpty());
+}
+
+void TestSegments::rejectsBadIndexHeader()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    SegmentWriter writer;
+    QVERIFY(writer.open(directory.path(), 1024 * 1024));
+    QVERIFY(addEntry(writer, "file.bin", patternData(100)));
+    writer.close();
+
+    QVERIFY(flipByte(directory.filePath(SegmentFormat::indexFileName(1)), 0));
+
+    SegmentReader reader;
+    QString errorMessage;
+    QVERIFY(!reader.open(directory.path(), &errorMessage));
+    QVERIFY(!errorMessage.isEmpty());
+}
+
+void TestSegments::ignoresEntriesOutsideDataFile()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    SegmentWriter writer;
+    QVERIFY(writer.open(directory.path(), 1024 * 1024));
+    QVERIFY(addEntry(writer, "file.bin", patternData(100)));
+    writer.close();
+
+    QFile indexFile(directory.filePath(SegmentFormat::indexFileName(1)));
+    QVERIFY(indexFile.open(QIODevice::Append));
+    QDataStream stream(&indexFile);
+    stream.setVersion(SegmentFormat::streamVersion);
+
+    const auto appendRecord = [&stream](const QString& name, qint32 segmentNumber, qint64 offset, qint64 length) {
+        SegmentEntry entry;
+        entry.name = name;
+        entry.segmentNumber = segmentNumber;
+        entry.offset = offset;
+        entry.length = length;
+        stream << entry;
+    };
+    appendRecord("huge.bin", 1, SegmentFormat::headerSize, qint64(1) << 60);
+    appendRecord("past-end.bin", 1, SegmentFormat::headerSize + 50, 51);
+    appendRecord("negative-offset.bin", 1, -100, 10);
+    appendRecord("negative-length.bin", 1, SegmentFormat::headerSize, -1);
+    appendRecord("in-header.bin", 1, 0, 4);
+    appendRecord("missing-segment.bin", 7, SegmentFormat::headerSize, 1);
+    appendRecord("file.bin", 1, std::numeric_limits<qint64>::max(), 1);
+    indexFile.close();
+
+    SegmentReader reader;
+    QVERIFY(reader.open(directory.path()));
+    QCOMPARE(reader.entryNames(), QStringList() << "file.bin");
+
+    QByteArray data;
+    QVERIFY(reader.read("file.bin", &data, key));
+    QCOMPARE(data, patternData(100));
+    QVERIFY(!reader.read("huge.bin", &data, key));
+}
+
+QTEST_GUILESS_MAIN(TestSegments)
+#include "tst_segments.moc"
@@ -0,0 +1,24 @@
+#ifndef TESTDATA_H
+#define TESTDATA_H
+
+#include <QByteArray>
+
+// Fixtures shared by the unit tests.
+namespace TestData {
+
+inline const QByteArray key = QByteArray::fromHex("0123456789ABCDEF");
+
+// Deterministic bytes that cover every value; seed gives a different sequence
+// of the same length.
+inline QByteArray patternData(qsizetype size, int seed = 0)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (qsizetype i = 0; i != size; ++i) {
+        data[i] = static_cast<char>((i * 131 + seed * 17 + 7) & 0xFF);
+    }
+    return data;
+}
+
+} // namespace TestData
+
+#endif // TESTDATA_H
@@ -0,0 +1,11 @@
+# Shared settings for the unit test projects.
+
+QT += testlib
+
+CONFIG += testcase console c++23
+CONFIG -= app_bundle
+
+# testdata.h
+INCLUDEPATH += $$PWD
+
+include($$PWD/../xorcore/xorcore.pri)
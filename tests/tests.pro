@@ -0,0 +1,18 @@
+# Unit tests, one Qt Test executable per directory. Build them through
+# FileXorProcessor.pro and run them with `make check`.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    bufferpool \
+    chunkcodec \
+    cputopology \
+    filelistmodel \
+    filequeue \
+    logger \
+    segments \
+    xorcodec \
+    xoriodevice
+
+# Drives XorPipe over pipe() pairs.
+unix: SUBDIRS += xorpipe
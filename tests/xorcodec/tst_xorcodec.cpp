@@ -0,0 +1,129 @@
+#include <QTest>
+#include "testdata.h"
+#include "xorcodec.h"
+
+namespace {
+
+using TestData::key;
+using TestData::patternData;
+
+QByteArray referenceXor(QByteArray data, const QByteArray& key, qint64 offset)
+{
+    for (qsizetype i = 0; i != data.size(); ++i) {
+        data[i] = static_cast<char>(data.at(i) ^ key.at((offset + i) % key.size()));
+    }
+    return data;
+}
+
+} // namespace
+
+class TestXorCodec : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void applyMatchesReference_data();
+    void applyMatchesReference();
+    void applyIsItsOwnInverse();
+    void chunkedApplyMatchesWhole();
+    void unalignedData();
+    void transformMatchesApply();
+    void neutralKey();
+};
+
+void TestXorCodec::applyMatchesReference_data()
+{
+    QTest::addColumn<qsizetype>("size");
+    QTest::addColumn<qint64>("offset");
+    QTest::addColumn<QByteArray>("key");
+
+    const QByteArray oddKey = QByteArray::fromHex("A55A3C");
+
+    for (qsizetype size : { 0, 1, 7, 8, 9, 63, 4096, 65537 }) {
+        for (qint64 offset : { 0, 3, 8, 13 }) {
+            QTest::addRow("8-byte key, %lld bytes at %lld", qlonglong(size), qlonglong(offset))
+                << size << offset << key;
+            QTest::addRow("3-byte key, %lld bytes at %lld", qlonglong(size), qlonglong(offset))
+                << size << offset << oddKey;
+        }
+    }
+}
+
+void TestXorCodec::applyMatchesReference()
+{
+    QFETCH(qsizetype, size);
+    QFETCH(qint64, offset);
+    QFETCH(QByteArray, key);
+
+    const QByteArray original = patternData(size);
+    QByteArray data = original;
+    XorCodec::apply(data, key, offset);
+
+    QCOMPARE(data, referenceXor(original, key, offset));
+}
+
+void TestXorCodec::applyIsItsOwnInverse()
+{
+    const QByteArray original = patternData(10000);
+
+    QByteArray data = original;
+    XorCodec::apply(data, key, 5);
+    QVERIFY(data != original);
+    XorCodec::apply(data, key, 5);
+    QCOMPARE(data, original);
+}
+
+void TestXorCodec::chunkedApplyMatchesWhole()
+{
+    const QByteArray original = patternData(100000);
+
+    QByteArray whole = original;
+    XorCodec::apply(whole, key, 0);
+
+    QByteArray chunked = original;
+    qint64 position = 0;
+    qsizetype chunkSize = 1;
+    while (position < chunked.size()) {
+        const qsizetype size = qMin<qsizetype>(chunkSize, chunked.size() - position);
+        XorCodec::apply(chunked.data() + position, size, key, position);
+        position += size;
+        chunkSize = chunkSize * 3 + 1;
+    }
+
+    QCOMPARE(chunked, whole);
+}
+
+void TestXorCodec::unalignedData()
+{
+    const QByteArray original = patternData(1000);
+
+    for (int shift = 1; shift != 8; ++shift) {
+        QByteArray data = original;
+        XorCodec::apply(data.data() + shift, data.size() - shift, key, 0);
+        QCOMPARE(data.left(shift), original.left(shift));
+        QCOMPARE(data.mid(shift), referenceXor(original.mid(shift), key, 0));
+    }
+}
+
+void TestXorCodec::transformMatchesApply()
+{
+    const QByteArray source = patternData(70000);
+
+    QByteArray destination(source.size(), Qt::Uninitialized);
+    XorCodec::transform(std::span<const char>(source.constData(), static_cast<size_t>(source.size())),
+                        std::span<char>(destination.data(), static_cast<size_t>(destination.size())),
+                        XorCodec::keySpan(key), 11);
+
+    QCOMPARE(destination, referenceXor(source, key, 11));
+}
+
+void TestXorCodec::neutralKey()
+{
+    QVERIFY(XorCodec::isNeutralKey(QByteArray(8, '\0')));
+    QVERIFY(XorCodec::isNeutralKey(QByteArray()));
+    QVERIFY(!XorCodec::isNeutralKey(QByteArray::fromHex("0000000000000001")));
+    QVERIFY(!XorCodec::isNeutralKey(key));
+}
+
+QTEST_GUILESS_MAIN(TestXorCodec)
+#include "tst_xorcodec.moc"
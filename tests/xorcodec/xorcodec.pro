@@ -0,0 +1,8 @@
+QT       = core
+
+TARGET = tst_xorcodec
+
+SOURCES += \
+    tst_xorcodec.cpp
+
+include(../tests.pri)
@@ -0,0 +1,190 @@
+#include <QBuffer>
+#include <QTest>
+#include "testdata.h"
+#include "xorcodec.h"
+#include "xoriodevice.h"
+
+#include <cstring>
+
+namespace {
+
+using TestData::key;
+using TestData::patternData;
+
+QByteArray encoded(QByteArray data, qint64 offset = 0)
+{
+    XorCodec::apply(data, key, offset);
+    return data;
+}
+
+// A sequential device with independent directions, like a socket: reads
+// come from incoming, writes go to outgoing.
+class DuplexDevice : public QIODevice
+{
+public:
+    explicit DuplexDevice(const QByteArray& incoming) : m_incoming(incoming) {}
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override { return m_incoming.size() - m_readPosition + QIODevice::bytesAvailable(); }
+
+    QByteArray outgoing() const { return m_outgoing; }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override
+    {
+        const qint64 size = qMin(maxSize, m_incoming.size() - m_readPosition);
+        std::memcpy(data, m_incoming.constData() + m_readPosition, static_cast<size_t>(size));
+        m_readPosition += size;
+        return size;
+    }
+
+    qint64 writeData(const char* data, qint64 maxSize) override
+    {
+        m_outgoing.append(data, maxSize);
+        return maxSize;
+    }
+
+private:
+    QByteArray m_incoming;
+    qint64 m_readPosition = 0;
+    QByteArray m_outgoing;
+};
+
+} // namespace
+
+class TestXorIODevice : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void readDecodes();
+    void writeEncodes();
+    void seekFollowsKeyPhase();
+    void keyOffsetSelectsPhase();
+    void openKeepsDevicePosition();
+    void opensClosedDevice();
+    void duplexDirectionsKeepOwnPhase();
+};
+
+void TestXorIODevice::readDecodes()
+{
+    const QByteArray original = patternData(200000);
+    QBuffer buffer;
+    buffer.setData(encoded(original));
+
+    XorIODevice device(&buffer, key);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+
+    QByteArray decoded;
+    while (!device.atEnd()) {
+        decoded.append(device.read(4099));
+    }
+    QCOMPARE(decoded, original);
+}
+
+void TestXorIODevice::writeEncodes()
+{
+    const QByteArray original = patternData(200000);
+    QBuffer buffer;
+
+    XorIODevice device(&buffer, key);
+    QVERIFY(device.open(QIODevice::WriteOnly));
+
+    qsizetype position = 0;
+    qsizetype chunkSize = 1;
+    while (position < original.size()) {
+        const qsizetype size = qMin<qsizetype>(chunkSize, original.size() - position);
+        QCOMPARE(device.write(original.constData() + position, size), qint64(size));
+        position += size;
+        chunkSize = chunkSize * 5 + 3;
+    }
+    device.close();
+
+    QCOMPARE(buffer.data(), encoded(original));
+}
+
+void TestXorIODevice::seekFollowsKeyPhase()
+{
+    const QByteArray original = patternData(10000);
+    QBuffer buffer;
+    buffer.setData(encoded(original));
+
+    XorIODevice device(&buffer, key);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+
+    QVERIFY(device.seek(4099));
+    QCOMPARE(device.pos(), qint64(4099));
+    QCOMPARE(device.read(100), original.mid(4099, 100));
+
+    QVERIFY(device.seek(3));
+    QCOMPARE(device.read(5), original.mid(3, 5));
+}
+
+void TestXorIODevice::keyOffsetSelectsPhase()
+{
+    const QByteArray original = patternData(1000);
+    const qint64 keyOffset = 13;
+    QBuffer buffer;
+    buffer.setData(encoded(original, keyOffset));
+
+    XorIODevice device(&buffer, key, keyOffset);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+    QCOMPARE(device.readAll(), original);
+}
+
+void TestXorIODevice::openKeepsDevicePosition()
+{
+    const QByteArray original = patternData(1000);
+    QBuffer buffer;
+    buffer.setData(encoded(original));
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QVERIFY(buffer.seek(100));
+
+    XorIODevice device(&buffer, key);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+    QCOMPARE(device.pos(), qint64(100));
+    QCOMPARE(device.readAll(), original.mid(100));
+
+    device.close();
+    QVERIFY(buffer.isOpen());
+}
+
+void TestXorIODevice::opensClosedDevice()
+{
+    QBuffer buffer;
+    XorIODevice device(&buffer, key);
+
+    QVERIFY(device.open(QIODevice::WriteOnly));
+    QVERIFY(buffer.isOpen());
+
+    device.close();
+    QVERIFY(!buffer.isOpen());
+}
+
+void TestXorIODevice::duplexDirectionsKeepOwnPhase()
+{
+    const QByteArray incoming = patternData(1000);
+    const QByteArray outgoing = patternData(1000).toBase64().left(1000);
+
+    DuplexDevice duplex(encoded(incoming));
+    QVERIFY(duplex.open(QIODevice::ReadWrite | QIODevice::Unbuffered));
+
+    XorIODevice device(&duplex, key);
+    QVERIFY(device.open(QIODevice::ReadWrite));
+
+    // Reads and writes of different sizes interleaved: each direction has to
+    // keep counting from its own start.
+    QByteArray received;
+    qsizetype sentSize = 0;
+    while (received.size() < incoming.size()) {
+        received.append(device.read(7));
+        QCOMPARE(device.write(outgoing.mid(sentSize, 3)), qint64(3));
+        sentSize += 3;
+    }
+
+    QCOMPARE(received, incoming);
+    QCOMPARE(duplex.outgoing(), encoded(outgoing.left(sentSize)));
+}
+
+QTEST_GUILESS_MAIN(TestXorIODevice)
+#include "tst_xoriodevice.moc"
@@ -0,0 +1,8 @@
+QT       = core
+
+TARGET = tst_xoriodevice
+
+SOURCES += \
+    tst_xoriodevice.cpp
+
+include(../tests.pri)
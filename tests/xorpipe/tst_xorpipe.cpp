@@ -0,0 +1,193 @@
+#include <QTemporaryFile>
+#include <QTest>
+#include <QThread>
+#include "testdata.h"
+#include "xorcodec.h"
+#include "xorpipe.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <memory>
+
+namespace {
+
+using TestData::key;
+using TestData::patternData;
+
+const QByteArray neutralKey(8, '\0');
+
+QByteArray encoded(QByteArray data, const QByteArray& xorKey)
+{
+    XorCodec::apply(data, xorKey, 0);
+    return data;
+}
+
+struct Pipe
+{
+    int readFd = -1;
+    int writeFd = -1;
+
+    Pipe()
+    {
+        int fds[2];
+        if (::pipe2(fds, O_CLOEXEC) == 0) {
+            readFd = fds[0];
+            writeFd = fds[1];
+        }
+    }
+    ~Pipe()
+    {
+        closeRead();
+        closeWrite();
+    }
+
+    bool isValid() const { return readFd != -1; }
+    void closeRead() { if (readFd != -1) { ::close(readFd); readFd = -1; } }
+    void closeWrite() { if (writeFd != -1) { ::close(writeFd); writeFd = -1; } }
+};
+
+// Writes data in uneven pieces, so that the transform sees short reads at
+// every key phase, then closes the pipe.
+std::unique_ptr<QThread> startWriter(Pipe& pipe, const QByteArray& data)
+{
+    std::unique_ptr<QThread> thread(QThread::create([&pipe, data]() {
+        qsizetype position = 0;
+        qsizetype pieceSize = 1;
+        while (position < data.size()) {
+            const ssize_t written = ::write(pipe.writeFd, data.constData() + position,
+                                            static_cast<size_t>(qMin(pieceSize, data.size() - position)));
+            if (written <= 0) {
+                break;
+            }
+            position += written;
+            pieceSize = pieceSize * 7 % 100003 + 1;
+        }
+        pipe.closeWrite();
+    }));
+    thread->start();
+    return thread;
+}
+
+// Reads until end of stream; a slow reader now and then lets the output pipe
+// fill up, so the transform has to wait before it can reuse a lent chunk.
+std::unique_ptr<QThread> startReader(Pipe& pipe, QByteArray* data, bool isSlow)
+{
+    std::unique_ptr<QThread> thread(QThread::create([&pipe, data, isSlow]() {
+        char buffer[12345];
+        for (int round = 0;; ++round) {
+            const ssize_t bytesRead = ::read(pipe.readFd, buffer, sizeof(buffer));
+            if (bytesRead <= 0) {
+                break;
+            }
+            data->append(buffer, bytesRead);
+            if (isSlow && round % 16 == 0) {
+                QThread::msleep(1);
+            }
+        }
+    }));
+    thread->start();
+    return thread;
+}
+
+} // namespace
+
+class TestXorPipe : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pipeToPipe_data();
+    void pipeToPipe();
+    void fileToPipe();
+    void pipeToFile();
+};
+
+void TestXorPipe::pipeToPipe_data()
+{
+    QTest::addColumn<QByteArray>("xorKey");
+    QTest::addColumn<bool>("useSplice");
+    QTest::addColumn<bool>("useVmsplice");
+    QTest::addColumn<bool>("isSlowReader");
+
+    QTest::newRow("vmsplice") << key << true << true << false;
+    QTest::newRow("vmsplice, slow reader") << key << true << true << true;
+    QTest::newRow("write") << key << true << false << false;
+    QTest::newRow("neutral key, splice") << neutralKey << true << true << false;
+    QTest::newRow("neutral key, copy") << neutralKey << false << true << true;
+}
+
+void TestXorPipe::pipeToPipe()
+{
+    QFETCH(QByteArray, xorKey);
+    QFETCH(bool, useSplice);
+    QFETCH(bool, useVmsplice);
+    QFETCH(bool, isSlowReader);
+
+    // Several times the ring (four chunks of half a 64 KiB pipe) goes round.
+    const QByteArray original = patternData(3 * 1024 * 1024 + 17);
+    Pipe input;
+    Pipe output;
+    QVERIFY(input.isValid() && output.isValid());
+
+    QByteArray received;
+    std::unique_ptr<QThread> writer = startWriter(input, original);
+    std::unique_ptr<QThread> reader = startReader(output, &received, isSlowReader);
+
+    XorPipe::Options options;
+    options.pipeSize = 64 * 1024;
+    options.useSplice = useSplice;
+    options.useVmsplice = useVmsplice;
+
+    qint64 bytesTransferred = 0;
+    QString errorMessage;
+    const bool isDone = XorPipe::run(input.readFd, output.writeFd, xorKey, options, &bytesTransferred, &errorMessage);
+    output.closeWrite();
+    writer->wait();
+    reader->wait();
+
+    QVERIFY2(isDone, qPrintable(errorMessage));
+    QCOMPARE(bytesTransferred, qint64(original.size()));
+    QCOMPARE(received, encoded(original, xorKey));
+}
+
+void TestXorPipe::fileToPipe()
+{
+    const QByteArray original = patternData(500000);
+    QTemporaryFile inputFile;
+    QVERIFY(inputFile.open());
+    QCOMPARE(inputFile.write(original), qint64(original.size()));
+    QVERIFY(inputFile.flush() && inputFile.seek(0));
+
+    Pipe output;
+    QVERIFY(output.isValid());
+    QByteArray received;
+    std::unique_ptr<QThread> reader = startReader(output, &received, false);
+
+    const bool isDone = XorPipe::run(inputFile.handle(), output.writeFd, key, XorPipe::Options());
+    output.closeWrite();
+    reader->wait();
+
+    QVERIFY(isDone);
+    QCOMPARE(received, encoded(original, key));
+}
+
+void TestXorPipe::pipeToFile()
+{
+    const QByteArray original = patternData(500000);
+    Pipe input;
+    QVERIFY(input.isValid());
+    std::unique_ptr<QThread> writer = startWriter(input, original);
+
+    QTemporaryFile outputFile;
+    QVERIFY(outputFile.open());
+    const bool isDone = XorPipe::run(input.readFd, outputFile.handle(), key, XorPipe::Options());
+    writer->wait();
+
+    QVERIFY(isDone);
+    QVERIFY(outputFile.seek(0));
+    QCOMPARE(outputFile.readAll(), encoded(original, key));
+}
+
+QTEST_GUILESS_MAIN(TestXorPipe)
+#include "tst_xorpipe.moc"
@@ -0,0 +1,8 @@
+QT       = core
+
+TARGET = tst_xorpipe
+
+SOURCES += \
+    tst_xorpipe.cpp
+
+include(../tests.pri)
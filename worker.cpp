@@ -1,16 +1,37 @@
 #include "worker.h"
+#include "fileutils.h"
+#include "xorcodec.h"
 
 #include <QFile>
-#include <QDataStream>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QDebug>
 
-Worker::Worker(QObject *parent)
+#include <optional>
+
+Worker::Worker(BufferPool *bufferPool, QObject *parent)
     : QObject{parent}
+    , m_bufferPool(bufferPool)
 {}
 
+bool Worker::setPlacement(const QList<int>& cpus, BufferPool *bufferPool) {
+    m_bufferPool = bufferPool;
+
+    // Threads that were never pinned are left alone, so the default
+    // configuration makes no affinity calls at all.
+    if (cpus.isEmpty() && !m_isPinned) {
+        return true;
+    }
+
+    const bool isPinned = CpuTopology::pinCurrentThread(cpus);
+    m_isPinned = isPinned && !cpus.isEmpty();
+    return isPinned;
+}
+
 void Worker::processFile(const QString& inputFilePath,
                  const QString& outputFilePath,
-                 const QByteArray& xorKey) {
+                 const QByteArray& xorKey,
+                 bool deleteInputFile) {
     m_abortRequested = false;
 
     if (xorKey.isEmpty()) {
@@ -19,55 +40,256 @@ void Worker::processFile(const QString& inputFilePath,
         return;
     }
 
+    emit statusChanged("Начата обработка файла: " + inputFilePath);
+    emit progressChanged(0);
+
+    QElapsedTimer processingTimer;
+    processingTimer.start();
+    m_metrics = FileMetrics();
+    m_phaseTimer.start();
+
+    bool isInputMoved = false;
+    bool isProcessed = false;
+
+    if (m_isPackedOutput) {
+        isProcessed = processIntoSegment(inputFilePath, QFileInfo(outputFilePath).fileName(), xorKey,
+                                         deleteInputFile);
+    } else {
+        // An all-zero key leaves the data as it is, so a same-filesystem rename
+        // is the whole job. Any other key goes through a copy that is synced and
+        // renamed into place before the input is deleted, so a crash never
+        // leaves the only copy of the data half transformed.
+        const bool isNeutral = !m_compression.isEnabled() && XorCodec::isNeutralKey(xorKey);
+        if (deleteInputFile && isNeutral) {
+            isInputMoved = FileUtils::moveFile(inputFilePath, outputFilePath);
+            m_metrics.addPhase(FileMetrics::Rename, m_phaseTimer);
+        }
+
+        if (isInputMoved) {
+            m_metrics.bytes = QFileInfo(outputFilePath).size();
+            m_metrics.outputBytes = m_metrics.bytes;
+            isProcessed = true;
+        } else {
+            isProcessed = processByCopy(inputFilePath, outputFilePath, xorKey, deleteInputFile);
+        }
+    }
+
+    if (m_abortRequested) {
+        emit statusChanged("Обработка прервана: " + inputFilePath);
+    } else if (isProcessed) {
+        emit statusChanged("Файл успешно обработан: " + outputFilePath);
+        emit progressChanged(100);
+
+        if (deleteInputFile) {
+            bool isDeleted = isInputMoved || QFile::remove(inputFilePath);
+            m_metrics.addPhase(FileMetrics::Delete, m_phaseTimer);
+            emit inputFileDeleted(inputFilePath, isDeleted);
+        }
+
+        m_metrics.processingNs = processingTimer.nsecsElapsed();
+        emit metricsReady(m_metrics);
+    }
+
+    emit finished();
+}
+
+void Worker::openSegments(const QString& outputDirectoryPath, qint64 segmentSize) {
+    // Files keep failing with a "segment not open" error rather than silently
+    // falling back to plain output when the segment cannot be created.
+    m_isPackedOutput = true;
+
+    QString errorMessage;
+    if (!m_segmentWriter.open(outputDirectoryPath, segmentSize, &errorMessage)) {
+        emit statusChanged(errorMessage);
+    }
+}
+
+void Worker::closeSegments() {
+    m_isPackedOutput = false;
+    m_segmentWriter.close();
+}
+
+void Worker::setCompressionOptions(const CompressionOptions& options) {
+    m_compression = options;
+}
+
+// Compression batches are charged to the pool together with the I/O buffer,
+// in one request, so a worker never holds one while waiting for the other.
+// The batch is made smaller until both fit in the pool.
+BufferPool::Buffer Worker::acquireBuffer(CompressionOptions& compression)
+{
+    if (!compression.isEnabled()) {
+        return m_bufferPool->acquire();
+    }
+
+    const qint64 capacity = m_bufferPool->capacity() - m_bufferPool->bufferSize();
+    compression.maxBatchSize = ChunkEncoder::batchSize(compression);
+    while (compression.maxBatchSize > 1 && ChunkEncoder::memoryFootprint(compression) > capacity) {
+        compression.maxBatchSize--;
+    }
+    return m_bufferPool->acquire(ChunkEncoder::memoryFootprint(compression));
+}
+
+bool Worker::processIntoSegment(const QString& inputFilePath,
+                                const QString& entryName,
+                                const QByteArray& xorKey,
+                                bool isDurable) {
     QFile inputFile(inputFilePath);
-    QFile outputFile(outputFilePath);
 
     if (!inputFile.open(QIODevice::ReadOnly)) {
         emit errorOccurred("Не удалось открыть входной файл: " + inputFilePath);
-        emit finished();
-        return;
+        return false;
     }
 
-    if (!outputFile.open(QIODevice::WriteOnly)) {
-        emit errorOccurred("Не удалось создать выходной файл: " + outputFilePath);
-        inputFile.close();
-        emit finished();
-        return;
+    // The input is deleted as soon as the entry is committed, so the commit
+    // has to reach the disk first.
+    m_segmentWriter.setDurable(isDurable);
+
+    QString errorMessage;
+    const quint32 entryFlags = m_compression.isEnabled() ? SegmentEntry::Compressed : 0;
+    if (!m_segmentWriter.beginEntry(entryName, QFileInfo(inputFile).lastModified(), entryFlags, &errorMessage)) {
+        emit errorOccurred(errorMessage);
+        return false;
     }
 
     const qint64 fileSize = inputFile.size();
-    const int keyLength = xorKey.length();
     qint64 totalBytesRead = 0;
-    const qint64 bufferSize = 64 * 1024; // 64Kb
+    m_metrics.addPhase(FileMetrics::Open, m_phaseTimer);
 
-    emit statusChanged("Начата обработка файла: " + inputFilePath);
-    emit progressChanged(0);
+    CompressionOptions compression = m_compression;
+    BufferPool::Buffer buffer = acquireBuffer(compression);
 
-    QDataStream in(&inputFile);
-    QDataStream out(&outputFile);
+    std::optional<ChunkEncoder> encoder;
+    if (compression.isEnabled()) {
+        encoder.emplace(compression, xorKey, [this](const char* data, qint64 size) {
+            return m_segmentWriter.write(data, size);
+        });
+    }
 
-    char *buffer = new char[bufferSize];
+    while (!inputFile.atEnd() && !m_abortRequested) {
+        qint64 bytesRead = inputFile.read(buffer.data(), buffer.size());
+
+        if (bytesRead == -1) {
+            errorMessage = "Ошибка чтения из файла: " + inputFilePath;
+            break;
+        }
+        m_metrics.addPhase(FileMetrics::Read, m_phaseTimer);
+
+        if (encoder) {
+            if (!encoder->write(buffer.data(), bytesRead)) {
+                errorMessage = "Ошибка записи в сегмент: " + entryName;
+                break;
+            }
+            m_metrics.addPhase(FileMetrics::Compress, m_phaseTimer);
+        } else {
+            XorCodec::apply(buffer.data(), bytesRead, xorKey, totalBytesRead);
+            m_metrics.addPhase(FileMetrics::Xor, m_phaseTimer);
+
+            if (!m_segmentWriter.write(buffer.data(), bytesRead)) {
+                errorMessage = "Ошибка записи в сегмент: " + entryName;
+                break;
+            }
+            m_metrics.addPhase(FileMetrics::Write, m_phaseTimer);
+        }
+
+        totalBytesRead += bytesRead;
+
+        if (fileSize > 0) {
+            emit progressChanged(static_cast<int>((totalBytesRead * 100) / fileSize));
+        }
+    }
+
+    if (encoder && !m_abortRequested && errorMessage.isEmpty() && !encoder->finish()) {
+        errorMessage = "Ошибка записи в сегмент: " + entryName;
+    }
+
+    if (m_abortRequested || !errorMessage.isEmpty()
+        || !m_segmentWriter.commitEntry(&errorMessage)) {
+        m_segmentWriter.abortEntry();
+        if (!errorMessage.isEmpty()) {
+            emit errorOccurred(errorMessage);
+        }
+        return false;
+    }
+    m_metrics.addPhase(FileMetrics::Close, m_phaseTimer);
+
+    m_metrics.bytes = totalBytesRead;
+    m_metrics.outputBytes = encoder ? encoder->bytesWritten() : totalBytesRead;
+    return true;
+}
+
+bool Worker::processByCopy(const QString& inputFilePath,
+                           const QString& outputFilePath,
+                           const QByteArray& xorKey,
+                           bool isDurable) {
+    if (!m_compression.isEnabled() && XorCodec::isNeutralKey(xorKey)
+        && FileUtils::cloneFile(inputFilePath, outputFilePath, isDurable)) {
+        m_metrics.addPhase(FileMetrics::Write, m_phaseTimer);
+        m_metrics.bytes = QFileInfo(inputFilePath).size();
+        m_metrics.outputBytes = m_metrics.bytes;
+        return true;
+    }
+
+    QFile inputFile(inputFilePath);
+    QFile plainOutputFile(outputFilePath);
+    QSaveFile durableOutputFile(outputFilePath);
+    QFileDevice& outputFile = isDurable ? static_cast<QFileDevice&>(durableOutputFile)
+                                        : static_cast<QFileDevice&>(plainOutputFile);
+
+    if (!inputFile.open(QIODevice::ReadOnly)) {
+        emit errorOccurred("Не удалось открыть входной файл: " + inputFilePath);
+        return false;
+    }
+
+    if (!outputFile.open(QIODevice::WriteOnly)) {
+        emit errorOccurred("Не удалось создать выходной файл: " + outputFilePath);
+        return false;
+    }
+
+    const qint64 fileSize = inputFile.size();
+    qint64 totalBytesRead = 0;
+    m_metrics.addPhase(FileMetrics::Open, m_phaseTimer);
+
+    CompressionOptions compression = m_compression;
+    BufferPool::Buffer buffer = acquireBuffer(compression);
     bool isErrorOccurred = false;
 
-    while(!in.atEnd() && !m_abortRequested && !isErrorOccurred) {
-        qint64 bytesRead = in.readRawData(buffer, bufferSize);
+    std::optional<ChunkEncoder> encoder;
+    if (compression.isEnabled()) {
+        encoder.emplace(compression, xorKey, [&outputFile](const char* data, qint64 size) {
+            return outputFile.write(data, size) == size;
+        });
+    }
+
+    while (!inputFile.atEnd() && !m_abortRequested) {
+        qint64 bytesRead = inputFile.read(buffer.data(), buffer.size());
 
         if (bytesRead == -1) {
             emit errorOccurred("Ошибка чтения из файла: " + inputFilePath);
             isErrorOccurred = true;
             break;
         }
+        m_metrics.addPhase(FileMetrics::Read, m_phaseTimer);
 
-        for (qint64 i = 0; i != bytesRead; ++i) {
-            buffer[i] = buffer[i] ^ xorKey[i % keyLength];
-        }
+        if (encoder) {
+            if (!encoder->write(buffer.data(), bytesRead)) {
+                emit errorOccurred("Ошибка записи в файл: " + outputFilePath);
+                isErrorOccurred = true;
+                break;
+            }
+            m_metrics.addPhase(FileMetrics::Compress, m_phaseTimer);
+        } else {
+            XorCodec::apply(buffer.data(), bytesRead, xorKey, totalBytesRead);
+            m_metrics.addPhase(FileMetrics::Xor, m_phaseTimer);
 
-        qint64 bytesWritten = out.writeRawData(buffer, bytesRead);
+            qint64 bytesWritten = outputFile.write(buffer.data(), bytesRead);
 
-        if (bytesWritten != bytesRead) {
-            emit errorOccurred("Ошибка записи в файл: " + outputFilePath);
-            isErrorOccurred = true;
-            break;
+            if (bytesWritten != bytesRead) {
+                emit errorOccurred("Ошибка записи в файл: " + outputFilePath);
+                isErrorOccurred = true;
+                break;
+            }
+            m_metrics.addPhase(FileMetrics::Write, m_phaseTimer);
         }
 
         totalBytesRead += bytesRead;
@@ -80,20 +302,34 @@ void Worker::processFile(const QString& inputFilePath,
         emit progressChanged(progress);
     }
 
-    delete [] buffer;
+    if (encoder && !m_abortRequested && !isErrorOccurred && !encoder->finish()) {
+        emit errorOccurred("Ошибка записи в файл: " + outputFilePath);
+        isErrorOccurred = true;
+    }
+
     inputFile.close();
-    outputFile.close();
 
-    if (m_abortRequested) {
-        outputFile.remove();
-        emit statusChanged("Обработка прервана: " + inputFilePath);
-    } else if (isErrorOccurred) {
-        outputFile.remove();
-    } else {
-        emit statusChanged("Файл успешно обработан: " + outputFile.fileName());
-        emit progressChanged(100);
+    if (m_abortRequested || isErrorOccurred) {
+        if (isDurable) {
+            durableOutputFile.cancelWriting();
+        } else {
+            plainOutputFile.close();
+            plainOutputFile.remove();
+        }
+        return false;
     }
 
-    emit finished();
+    // QSaveFile::commit syncs the temporary file and renames it over the output;
+    // the directory sync makes the rename itself survive a crash.
+    if (isDurable && (!durableOutputFile.commit()
+                      || !FileUtils::syncDirectory(QFileInfo(outputFilePath).absolutePath()))) {
+        emit errorOccurred("Ошибка записи в файл: " + outputFilePath);
+        return false;
+    }
+    plainOutputFile.close();
+    m_metrics.addPhase(FileMetrics::Close, m_phaseTimer);
 
+    m_metrics.bytes = totalBytesRead;
+    m_metrics.outputBytes = encoder ? encoder->bytesWritten() : totalBytesRead;
+    return true;
 }
@@ -2,25 +2,58 @@
 #define WORKER_H
 
 #include <QObject>
+#include <QElapsedTimer>
+#include "bufferpool.h"
+#include "filemetrics.h"
+#include "segmentwriter.h"
+#include "chunkcodec.h"
 
 class Worker : public QObject
 {
     Q_OBJECT
 public:
-    explicit Worker(QObject *parent = nullptr);
+    explicit Worker(BufferPool *bufferPool, QObject *parent = nullptr);
+
+    // Must run on the worker's own thread (queue it with invokeMethod): pins
+    // the thread to cpus, or unpins it when empty, and switches to the
+    // buffer pool of its node. Returns false when pinning failed.
+    bool setPlacement(const QList<int>& cpus, BufferPool *bufferPool);
 
 public slots:
     void processFile(const QString& inputFilePath,
                      const QString& outputFilePath,
-                     const QByteArray& xorKey);
+                     const QByteArray& xorKey,
+                     bool deleteInputFile);
+    void openSegments(const QString& outputDirectoryPath, qint64 segmentSize);
+    void closeSegments();
+    void setCompressionOptions(const CompressionOptions& options);
 signals:
     void progressChanged(int percent);
     void statusChanged(const QString& status);
     void finished();
     void errorOccurred(const QString& errorMessage);
+    void inputFileDeleted(const QString& filePath, bool success);
+    void metricsReady(const FileMetrics& metrics);
 
 private:
+    BufferPool *m_bufferPool;
+    bool m_isPinned = false;
     bool m_abortRequested = false;
+    FileMetrics m_metrics;
+    QElapsedTimer m_phaseTimer;
+    SegmentWriter m_segmentWriter;
+    bool m_isPackedOutput = false;
+    CompressionOptions m_compression;
+
+    BufferPool::Buffer acquireBuffer(CompressionOptions& compression);
+    bool processByCopy(const QString& inputFilePath,
+                       const QString& outputFilePath,
+                       const QByteArray& xorKey,
+                       bool isDurable);
+    bool processIntoSegment(const QString& inputFilePath,
+                            const QString& entryName,
+                            const QByteArray& xorKey,
+                            bool isDurable);
 };
 
 #endif // WORKER_H
@@ -0,0 +1,31 @@
+#include "checksum.h"
+
+#include <array>
+
+namespace {
+
+constexpr std::array<quint32, 256> makeTable()
+{
+    std::array<quint32, 256> table {};
+    for (quint32 i = 0; i != 256; ++i) {
+        quint32 value = i;
+        for (int bit = 0; bit != 8; ++bit) {
+            value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+        }
+        table[i] = value;
+    }
+    return table;
+}
+
+constexpr std::array<quint32, 256> crcTable = makeTable();
+
+} // namespace
+
+quint32 Crc32::update(quint32 crc, const char* data, qint64 size)
+{
+    crc = ~crc;
+    for (qint64 i = 0; i != size; ++i) {
+        crc = crcTable[(crc ^ static_cast<quint8>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
@@ -0,0 +1,14 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <QtGlobal>
+
+// CRC-32 (IEEE 802.3, as used by zlib). Feed chunks through update(),
+// starting from 0.
+class Crc32
+{
+public:
+    static quint32 update(quint32 crc, const char* data, qint64 size);
+};
+
+#endif // CHECKSUM_H
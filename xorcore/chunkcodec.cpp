@@ -0,0 +1,304 @@
+#include "chunkcodec.h"
+#include "checksum.h"
+#include "xorcodec.h"
+
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtEndian>
+
+#include <optional>
+
+namespace {
+
+int poolBatchSize()
+{
+    return qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+}
+
+void appendUInt32(QByteArray& bytes, quint32 value)
+{
+    char buffer[4];
+    qToLittleEndian(value, buffer);
+    bytes.append(buffer, 4);
+}
+
+quint32 readUInt32(const char* data)
+{
+    return qFromLittleEndian<quint32>(data);
+}
+
+QByteArray encodeFrame(QByteArray raw, int level, CompressionOptions::Order order, const QByteArray& xorKey)
+{
+    if (order == CompressionOptions::XorThenCompress) {
+        XorCodec::apply(raw.data(), raw.size(), xorKey, 0);
+    }
+
+    QByteArray stored = qCompress(raw, level);
+    const bool isStoredRaw = stored.size() >= raw.size();
+    if (isStoredRaw) {
+        stored = raw;
+    }
+
+    if (order == CompressionOptions::CompressThenXor) {
+        XorCodec::apply(stored.data(), stored.size(), xorKey, 0);
+    }
+
+    QByteArray frame;
+    frame.reserve(ChunkFormat::frameHeaderSize + stored.size());
+    appendUInt32(frame, static_cast<quint32>(raw.size()));
+    appendUInt32(frame, static_cast<quint32>(stored.size()) | (isStoredRaw ? ChunkFormat::storedRawFlag : 0));
+    appendUInt32(frame, Crc32::update(0, stored.constData(), stored.size()));
+    frame.append(stored);
+    return frame;
+}
+
+std::optional<QByteArray> decodeFrame(const QByteArray& frame, CompressionOptions::Order order, const QByteArray& xorKey)
+{
+    const quint32 rawSize = readUInt32(frame.constData());
+    const bool isStoredRaw = readUInt32(frame.constData() + 4) & ChunkFormat::storedRawFlag;
+    const quint32 checksum = readUInt32(frame.constData() + 8);
+
+    QByteArray stored = frame.mid(ChunkFormat::frameHeaderSize);
+    if (Crc32::update(0, stored.constData(), stored.size()) != checksum) {
+        return std::nullopt;
+    }
+
+    if (order == CompressionOptions::CompressThenXor) {
+        XorCodec::apply(stored.data(), stored.size(), xorKey, 0);
+    }
+
+    // qUncompress sizes its buffer from the big-endian length prefix, so that
+    // has to agree with the frame before anything is allocated.
+    if (isStoredRaw ? static_cast<quint32>(stored.size()) != rawSize
+                    : stored.size() < 4 || qFromBigEndian<quint32>(stored.constData()) != rawSize) {
+        return std::nullopt;
+    }
+
+    QByteArray raw = isStoredRaw ? stored : qUncompress(stored);
+    if (static_cast<quint32>(raw.size()) != rawSize) {
+        return std::nullopt;
+    }
+
+    if (order == CompressionOptions::XorThenCompress) {
+        XorCodec::apply(raw.data(), raw.size(), xorKey, 0);
+    }
+    return raw;
+}
+
+} // namespace
+
+ChunkEncoder::ChunkEncoder(const CompressionOptions& options, const QByteArray& xorKey, Sink sink)
+    : m_options(options)
+    , m_xorKey(xorKey)
+    , m_sink(std::move(sink))
+{
+    m_options.chunkSize = qBound(ChunkFormat::minChunkSize, m_options.chunkSize, ChunkFormat::maxChunkSize);
+}
+
+bool ChunkEncoder::write(const char* data, qint64 size)
+{
+    m_pending.append(data, size);
+
+    qsizetype position = 0;
+    while (m_pending.size() - position >= m_options.chunkSize) {
+        m_batch.append(m_pending.mid(position, m_options.chunkSize));
+        position += m_options.chunkSize;
+
+        if (m_batch.size() >= batchSize(m_options) && !flushBatch()) {
+            return false;
+        }
+    }
+    m_pending.remove(0, position);
+
+    return true;
+}
+
+qint64 ChunkEncoder::memoryFootprint(const CompressionOptions& options)
+{
+    const qint64 chunkSize = qBound(ChunkFormat::minChunkSize, options.chunkSize, ChunkFormat::maxChunkSize);
+    return chunkSize * (1 + 3 * static_cast<qint64>(batchSize(options)));
+}
+
+int ChunkEncoder::batchSize(const CompressionOptions& options)
+{
+    return options.maxBatchSize > 0 ? qMin(options.maxBatchSize, poolBatchSize()) : poolBatchSize();
+}
+
+bool ChunkEncoder::finish()
+{
+    if (!m_pending.isEmpty()) {
+        m_batch.append(m_pending);
+        m_pending.clear();
+    }
+    return flushBatch() && (m_isHeaderWritten || writeHeader());
+}
+
+bool ChunkEncoder::writeHeader()
+{
+    QByteArray header;
+    appendUInt32(header, ChunkFormat::magic);
+    header.append(static_cast<char>(ChunkFormat::version));
+    header.append(static_cast<char>(m_options.order));
+    header.append(2, '\0');
+    appendUInt32(header, static_cast<quint32>(m_options.chunkSize));
+
+    m_isHeaderWritten = true;
+    return emitBytes(header);
+}
+
+bool ChunkEncoder::flushBatch()
+{
+    if (m_batch.isEmpty()) {
+        return true;
+    }
+
+    if (!m_isHeaderWritten && !writeHeader()) {
+        return false;
+    }
+
+    const int level = m_options.level;
+    const CompressionOptions::Order order = m_options.order;
+    const QByteArray xorKey = m_xorKey;
+    auto encode = [level, order, xorKey](const QByteArray& raw) {
+        return encodeFrame(raw, level, order, xorKey);
+    };
+
+    // A lone chunk (small files) is not worth a round trip through the pool.
+    const QList<QByteArray> frames = m_batch.size() == 1
+        ? QList<QByteArray>{ encode(m_batch.first()) }
+        : QtConcurrent::blockingMapped<QList<QByteArray>>(m_batch, encode);
+    m_batch.clear();
+
+    for (const QByteArray& frame : frames) {
+        if (!emitBytes(frame)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ChunkEncoder::emitBytes(const QByteArray& bytes)
+{
+    if (!m_sink(bytes.constData(), bytes.size())) {
+        return false;
+    }
+    m_bytesWritten += bytes.size();
+    return true;
+}
+
+ChunkDecoder::ChunkDecoder(const QByteArray& xorKey, Sink sink)
+    : m_xorKey(xorKey)
+    , m_sink(std::move(sink))
+{}
+
+bool ChunkDecoder::write(const char* data, qint64 size)
+{
+    if (!m_errorString.isEmpty()) {
+        return false;
+    }
+
+    m_buffer.append(data, size);
+    if (!parseFrames()) {
+        return false;
+    }
+
+    m_buffer.remove(0, m_position);
+    m_position = 0;
+
+    return m_batch.size() < poolBatchSize() || flushBatch();
+}
+
+bool ChunkDecoder::finish()
+{
+    if (!m_errorString.isEmpty() || !flushBatch()) {
+        return false;
+    }
+    if (!m_isHeaderRead || m_position != m_buffer.size()) {
+        return fail("Сжатый поток обрезан");
+    }
+    return true;
+}
+
+bool ChunkDecoder::parseFrames()
+{
+    if (!m_isHeaderRead) {
+        if (m_buffer.size() < ChunkFormat::headerSize) {
+            return true;
+        }
+
+        const char* header = m_buffer.constData();
+        if (readUInt32(header) != ChunkFormat::magic || static_cast<quint8>(header[4]) != ChunkFormat::version) {
+            return fail("Неверный формат сжатого потока");
+        }
+
+        if (header[5] != CompressionOptions::CompressThenXor && header[5] != CompressionOptions::XorThenCompress) {
+            return fail("Неверный формат сжатого потока");
+        }
+
+        m_chunkSize = readUInt32(header + 8);
+        if (m_chunkSize < ChunkFormat::minChunkSize || m_chunkSize > ChunkFormat::maxChunkSize) {
+            return fail("Неверный размер фрейма сжатого потока");
+        }
+
+        m_order = static_cast<CompressionOptions::Order>(header[5]);
+        m_position = ChunkFormat::headerSize;
+        m_isHeaderRead = true;
+    }
+
+    while (m_buffer.size() - m_position >= ChunkFormat::frameHeaderSize) {
+        const quint32 rawSize = readUInt32(m_buffer.constData() + m_position);
+        const quint32 storedSize = readUInt32(m_buffer.constData() + m_position + 4) & ~ChunkFormat::storedRawFlag;
+        if (rawSize > m_chunkSize || storedSize > m_chunkSize) {
+            return fail("Повреждённый фрейм сжатого потока");
+        }
+
+        const qsizetype frameSize = ChunkFormat::frameHeaderSize + storedSize;
+
+        if (m_buffer.size() - m_position < frameSize) {
+            break;
+        }
+
+        m_batch.append(m_buffer.mid(m_position, frameSize));
+        m_position += frameSize;
+
+        if (m_batch.size() >= poolBatchSize() && !flushBatch()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ChunkDecoder::flushBatch()
+{
+    if (m_batch.isEmpty()) {
+        return true;
+    }
+
+    const CompressionOptions::Order order = m_order;
+    const QByteArray xorKey = m_xorKey;
+    auto decode = [order, xorKey](const QByteArray& frame) {
+        return decodeFrame(frame, order, xorKey);
+    };
+
+    const QList<std::optional<QByteArray>> chunks = m_batch.size() == 1
+        ? QList<std::optional<QByteArray>>{ decode(m_batch.first()) }
+        : QtConcurrent::blockingMapped<QList<std::optional<QByteArray>>>(m_batch, decode);
+    m_batch.clear();
+
+    for (const std::optional<QByteArray>& chunk : chunks) {
+        if (!chunk) {
+            return fail("Повреждённый фрейм сжатого потока");
+        }
+        if (!m_sink(chunk->constData(), chunk->size())) {
+            return fail("Ошибка записи распакованных данных");
+        }
+    }
+    return true;
+}
+
+bool ChunkDecoder::fail(const QString& errorString)
+{
+    m_errorString = errorString;
+    return false;
+}
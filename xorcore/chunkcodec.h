@@ -0,0 +1,110 @@
+#ifndef CHUNKCODEC_H
+#define CHUNKCODEC_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include <functional>
+
+struct CompressionOptions
+{
+    enum Order : quint8 {
+        CompressThenXor,
+        XorThenCompress
+    };
+
+    int level = 0; // 0 disables the stage, 1-9 are zlib levels
+    Order order = CompressThenXor;
+    qint64 chunkSize = 1024 * 1024;
+    int maxBatchSize = 0; // chunks encoded at once; 0: one per pool thread
+
+    bool isEnabled() const { return level > 0; }
+};
+
+Q_DECLARE_METATYPE(CompressionOptions)
+
+// Compressed stream format: a 12-byte header followed by independent frames.
+//
+//   header: magic "XZC1" | version u8 | order u8 | reserved u16 | chunk size u32
+//   frame:  raw size u32 | stored size u32 (top bit: stored uncompressed) |
+//           CRC-32 of stored bytes u32 | stored bytes
+//
+// All integers are little-endian. Every frame is compressed and XORed on its
+// own (key phase restarts at 0), so frames can be encoded and decoded in
+// parallel; the encoder and decoder do so in batches on the global thread pool.
+// Neither size of a frame may exceed the chunk size from the header, which
+// bounds what the decoder buffers for a corrupt or hostile stream.
+namespace ChunkFormat {
+
+constexpr quint32 magic = 0x31435A58; // "XZC1"
+constexpr quint8 version = 1;
+constexpr int headerSize = 12;
+constexpr int frameHeaderSize = 12;
+constexpr quint32 storedRawFlag = 0x80000000u;
+constexpr qint64 minChunkSize = 4096;
+constexpr qint64 maxChunkSize = 64 * 1024 * 1024;
+
+} // namespace ChunkFormat
+
+class ChunkEncoder
+{
+public:
+    using Sink = std::function<bool(const char*, qint64)>;
+
+    ChunkEncoder(const CompressionOptions& options, const QByteArray& xorKey, Sink sink);
+
+    bool write(const char* data, qint64 size);
+    bool finish();
+
+    qint64 bytesWritten() const { return m_bytesWritten; }
+
+    // Most memory an encoder holds at once with these options: the pending
+    // chunk plus, for every chunk of a batch, its raw copy, the compressor's
+    // output and the finished frame.
+    static qint64 memoryFootprint(const CompressionOptions& options);
+    static int batchSize(const CompressionOptions& options);
+
+private:
+    CompressionOptions m_options;
+    QByteArray m_xorKey;
+    Sink m_sink;
+    QByteArray m_pending;
+    QList<QByteArray> m_batch;
+    bool m_isHeaderWritten = false;
+    qint64 m_bytesWritten = 0;
+
+    bool writeHeader();
+    bool flushBatch();
+    bool emitBytes(const QByteArray& bytes);
+};
+
+class ChunkDecoder
+{
+public:
+    using Sink = std::function<bool(const char*, qint64)>;
+
+    ChunkDecoder(const QByteArray& xorKey, Sink sink);
+
+    bool write(const char* data, qint64 size);
+    bool finish();
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    QByteArray m_xorKey;
+    Sink m_sink;
+    QByteArray m_buffer;
+    qsizetype m_position = 0;
+    QList<QByteArray> m_batch;
+    CompressionOptions::Order m_order = CompressionOptions::CompressThenXor;
+    quint32 m_chunkSize = 0;
+    bool m_isHeaderRead = false;
+    QString m_errorString;
+
+    bool parseFrames();
+    bool flushBatch();
+    bool fail(const QString& errorString);
+};
+
+#endif // CHUNKCODEC_H
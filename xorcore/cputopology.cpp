@@ -0,0 +1,222 @@
+#include "cputopology.h"
+
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QThread>
+
+#include <algorithm>
+#include <new>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+static_assert(CpuTopology::maxCpuCount == CPU_SETSIZE);
+#endif
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+#ifdef XORCORE_HAVE_LIBNUMA
+#include <numa.h>
+#endif
+
+namespace {
+
+QList<CpuTopology::Node> readNodes()
+{
+    QList<CpuTopology::Node> nodes;
+
+#ifdef Q_OS_LINUX
+    const QDir nodeDir("/sys/devices/system/node");
+    const QStringList entries = nodeDir.entryList(QStringList() << "node*", QDir::Dirs);
+    static const QRegularExpression nodeName("^node(\\d+)$");
+
+    for (const QString& entry : entries) {
+        const QRegularExpressionMatch match = nodeName.match(entry);
+        if (!match.hasMatch()) {
+            continue;
+        }
+
+        QFile cpuListFile(nodeDir.filePath(entry + "/cpulist"));
+        CpuTopology::Node node;
+        node.id = match.captured(1).toInt();
+        if (cpuListFile.open(QIODevice::ReadOnly)
+            && CpuTopology::parseCpuList(QString::fromLatin1(cpuListFile.readAll()).trimmed(), &node.cpus)
+            && !node.cpus.isEmpty()) {
+            nodes.append(node);
+        }
+    }
+#elif defined(Q_OS_WIN)
+    ULONG highestNode = 0;
+    if (GetNumaHighestNodeNumber(&highestNode)) {
+        for (USHORT nodeId = 0; nodeId <= highestNode; ++nodeId) {
+            GROUP_AFFINITY affinity;
+            // Only processor group 0 is used, which covers up to 64 CPUs.
+            if (!GetNumaNodeProcessorMaskEx(nodeId, &affinity) || affinity.Group != 0) {
+                continue;
+            }
+            CpuTopology::Node node;
+            node.id = nodeId;
+            for (int cpu = 0; cpu != 64; ++cpu) {
+                if (affinity.Mask & (KAFFINITY(1) << cpu)) {
+                    node.cpus.append(cpu);
+                }
+            }
+            if (!node.cpus.isEmpty()) {
+                nodes.append(node);
+            }
+        }
+    }
+#endif
+
+    if (nodes.isEmpty()) {
+        CpuTopology::Node node;
+        for (int cpu = 0; cpu != QThread::idealThreadCount(); ++cpu) {
+            node.cpus.append(cpu);
+        }
+        nodes.append(node);
+    }
+
+    std::sort(nodes.begin(), nodes.end(), [](const CpuTopology::Node& left, const CpuTopology::Node& right) {
+        return left.id < right.id;
+    });
+    return nodes;
+}
+
+#ifdef XORCORE_HAVE_LIBNUMA
+bool isLibnumaAvailable()
+{
+    static const bool isAvailable = numa_available() != -1;
+    return isAvailable;
+}
+#endif
+
+} // namespace
+
+QList<CpuTopology::Node> CpuTopology::nodes()
+{
+    static const QList<Node> topology = readNodes();
+    return topology;
+}
+
+bool CpuTopology::pinCurrentThread(const QList<int>& cpus)
+{
+#ifdef Q_OS_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    if (cpus.isEmpty()) {
+        // Back to what the process was started with (the main thread is
+        // never pinned), not to every CPU, so taskset limits still hold.
+        if (sched_getaffinity(getpid(), sizeof(set), &set) != 0) {
+            return false;
+        }
+    }
+
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return CPU_COUNT(&set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(Q_OS_WIN)
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        return false;
+    }
+
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < int(sizeof(DWORD_PTR) * 8)) {
+            mask |= DWORD_PTR(1) << cpu;
+        }
+    }
+    mask = cpus.isEmpty() ? processMask : (mask & processMask);
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+    return cpus.isEmpty();
+#endif
+}
+
+bool CpuTopology::parseCpuList(const QString& text, QList<int>* cpus)
+{
+    QList<int> result;
+
+    for (const QString& part : text.split(',', Qt::SkipEmptyParts)) {
+        const QStringList bounds = part.trimmed().split('-');
+        bool isFirstValid = false;
+        bool isLastValid = false;
+        const int first = bounds.first().toInt(&isFirstValid);
+        const int last = bounds.size() == 2 ? bounds.last().toInt(&isLastValid) : first;
+
+        if (!isFirstValid || (bounds.size() == 2 && !isLastValid) || bounds.size() > 2
+            || first < 0 || last < first || last >= maxCpuCount) {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            result.append(cpu);
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    *cpus = result;
+    return true;
+}
+
+QString CpuTopology::formatCpuList(const QList<int>& cpus)
+{
+    QStringList ranges;
+
+    for (qsizetype i = 0; i < cpus.size();) {
+        qsizetype end = i;
+        while (end + 1 < cpus.size() && cpus.at(end + 1) == cpus.at(end) + 1) {
+            ++end;
+        }
+        ranges.append(end == i ? QString::number(cpus.at(i))
+                               : QString("%1-%2").arg(cpus.at(i)).arg(cpus.at(end)));
+        i = end + 1;
+    }
+    return ranges.join(',');
+}
+
+char* CpuTopology::allocateOnNode(qint64 size, int node)
+{
+#ifdef XORCORE_HAVE_LIBNUMA
+    if (node >= 0 && isLibnumaAvailable()) {
+        void* data = numa_alloc_onnode(static_cast<size_t>(size), node);
+        if (!data) {
+            throw std::bad_alloc();
+        }
+        return static_cast<char*>(data);
+    }
+#endif
+
+    char* data = static_cast<char*>(::operator new(static_cast<size_t>(size), std::align_val_t(pageSize)));
+    if (node >= 0) {
+        for (qint64 offset = 0; offset < size; offset += pageSize) {
+            data[offset] = 0;
+        }
+    }
+    return data;
+}
+
+void CpuTopology::freeOnNode(char* data, qint64 size, int node)
+{
+#ifdef XORCORE_HAVE_LIBNUMA
+    if (node >= 0 && isLibnumaAvailable()) {
+        numa_free(data, static_cast<size_t>(size));
+        return;
+    }
+#else
+    Q_UNUSED(size);
+    Q_UNUSED(node);
+#endif
+
+    ::operator delete(data, std::align_val_t(pageSize));
+}
@@ -0,0 +1,42 @@
+#ifndef CPUTOPOLOGY_H
+#define CPUTOPOLOGY_H
+
+#include <QList>
+#include <QString>
+
+// NUMA layout of the machine and the per-thread placement primitives built
+// on it. Everything degrades to a single node holding every CPU where the
+// platform reports nothing better, so callers need no special cases for
+// single-socket machines.
+class CpuTopology
+{
+public:
+    struct Node
+    {
+        int id = 0;
+        QList<int> cpus;
+    };
+
+    static QList<Node> nodes();
+    static bool isNuma() { return nodes().size() > 1; }
+
+    // Restricts the calling thread to cpus; an empty list restores the
+    // process-wide affinity.
+    static bool pinCurrentThread(const QList<int>& cpus);
+
+    // "0-3,8,10-11" <-> {0,1,2,3,8,10,11}. Returns false on malformed input,
+    // inverted ranges and ids of maxCpuCount or more.
+    static bool parseCpuList(const QString& text, QList<int>* cpus);
+    static QString formatCpuList(const QList<int>& cpus);
+
+    // Page-aligned memory placed on node: through libnuma when built with
+    // CONFIG+=numa, otherwise by touching every page from the calling thread,
+    // which must then already run on that node. node < 0 allocates anywhere.
+    static char* allocateOnNode(qint64 size, int node);
+    static void freeOnNode(char* data, qint64 size, int node);
+
+    static constexpr qint64 pageSize = 4096;
+    static constexpr int maxCpuCount = 1024; // CPU_SETSIZE
+};
+
+#endif // CPUTOPOLOGY_H
@@ -0,0 +1,58 @@
+#ifndef SEGMENTFORMAT_H
+#define SEGMENTFORMAT_H
+
+#include <QDataStream>
+#include <QString>
+
+// Packed output: XORed payloads are appended back to back to
+// segment-NNNNNN.xpk data files. Each data file has a companion
+// segment-NNNNNN.xpi index of SegmentEntry records, appended once the
+// payload has been fully written.
+namespace SegmentFormat {
+
+constexpr quint32 dataMagic = 0x58504B44;  // "XPKD"
+constexpr quint32 indexMagic = 0x58504B49; // "XPKI"
+constexpr quint32 version = 2;
+constexpr qint64 headerSize = 8;
+constexpr QDataStream::Version streamVersion = QDataStream::Qt_6_0;
+
+inline QString dataFileName(int segmentNumber)
+{
+    return QString("segment-%1.xpk").arg(segmentNumber, 6, 10, QChar('0'));
+}
+
+inline QString indexFileName(int segmentNumber)
+{
+    return QString("segment-%1.xpi").arg(segmentNumber, 6, 10, QChar('0'));
+}
+
+} // namespace SegmentFormat
+
+struct SegmentEntry
+{
+    enum Flag : quint32 {
+        Compressed = 0x1 // payload is a ChunkEncoder stream
+    };
+
+    QString name;
+    qint32 segmentNumber = 0;
+    qint64 offset = 0;
+    qint64 length = 0;
+    quint32 checksum = 0;
+    qint64 modifiedMs = 0;
+    quint32 flags = 0;
+};
+
+inline QDataStream& operator<<(QDataStream& stream, const SegmentEntry& entry)
+{
+    return stream << entry.name << entry.segmentNumber << entry.offset
+                  << entry.length << entry.checksum << entry.modifiedMs << entry.flags;
+}
+
+inline QDataStream& operator>>(QDataStream& stream, SegmentEntry& entry)
+{
+    return stream >> entry.name >> entry.segmentNumber >> entry.offset
+                  >> entry.length >> entry.checksum >> entry.modifiedMs >> entry.flags;
+}
+
+#endif // SEGMENTFORMAT_H
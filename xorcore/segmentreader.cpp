@@ -0,0 +1,225 @@
+#include "segmentreader.h"
+#include "checksum.h"
+#include "xorcodec.h"
+#include "chunkcodec.h"
+
+#include <QBuffer>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <optional>
+
+namespace {
+
+const qint64 bufferSize = 64 * 1024; // 64Kb
+
+} // namespace
+
+bool SegmentReader::open(const QString& directoryPath, QString* errorMessage)
+{
+    m_directory = QDir(directoryPath);
+    m_entries.clear();
+
+    if (!m_directory.exists()) {
+        if (errorMessage) {
+            *errorMessage = "Директория сегментов не существует: " + directoryPath;
+        }
+        return false;
+    }
+
+    // Zero-padded numbers make name order the same as segment order.
+    const QStringList indexFiles = m_directory.entryList(QStringList() << "segment-*.xpi", QDir::Files, QDir::Name);
+    for (const QString& indexFile : indexFiles) {
+        if (!loadIndex(m_directory.absoluteFilePath(indexFile), errorMessage)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SegmentReader::loadIndex(const QString& indexFilePath, QString* errorMessage)
+{
+    QFile indexFile(indexFilePath);
+    if (!indexFile.open(QIODevice::ReadOnly)) {
+        if (errorMessage) {
+            *errorMessage = "Не удалось открыть индекс сегмента: " + indexFilePath;
+        }
+        return false;
+    }
+
+    QDataStream stream(&indexFile);
+    stream.setVersion(SegmentFormat::streamVersion);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != SegmentFormat::indexMagic || version != SegmentFormat::version) {
+        if (errorMessage) {
+            *errorMessage = "Неверный формат индекса сегмента: " + indexFilePath;
+        }
+        return false;
+    }
+
+    // A record cut short by a crash is ignored: its payload was never committed.
+    // So is one that points outside its data file, which only a damaged index
+    // can contain; nothing is ever read or allocated on its say-so.
+    QHash<qint32, qint64> dataFileSizes;
+    while (!stream.atEnd()) {
+        SegmentEntry entry;
+        stream >> entry;
+        if (stream.status() != QDataStream::Ok) {
+            break;
+        }
+
+        auto dataFileSize = dataFileSizes.constFind(entry.segmentNumber);
+        if (dataFileSize == dataFileSizes.constEnd()) {
+            const QFileInfo dataFileInfo(m_directory.absoluteFilePath(SegmentFormat::dataFileName(entry.segmentNumber)));
+            dataFileSize = dataFileSizes.insert(entry.segmentNumber, dataFileInfo.isFile() ? dataFileInfo.size() : -1);
+        }
+
+        if (entry.offset < SegmentFormat::headerSize || entry.length < 0
+            || entry.length > *dataFileSize - entry.offset) {
+            continue;
+        }
+        m_entries.insert(entry.name, entry);
+    }
+
+    return true;
+}
+
+bool SegmentReader::read(const QString& name, QByteArray* data,
+                         const QByteArray& xorKey, QString* errorMessage) const
+{
+    auto it = m_entries.constFind(name);
+    if (it == m_entries.constEnd()) {
+        if (errorMessage) {
+            *errorMessage = "Запись не найдена: " + name;
+        }
+        return false;
+    }
+
+    data->clear();
+    QBuffer buffer(data);
+    buffer.open(QIODevice::WriteOnly);
+
+    if (!copyEntry(*it, xorKey, &buffer, errorMessage)) {
+        buffer.close();
+        data->clear();
+        return false;
+    }
+    return true;
+}
+
+bool SegmentReader::extract(const QString& name, const QString& outputFilePath,
+                            const QByteArray& xorKey, QString* errorMessage) const
+{
+    auto it = m_entries.constFind(name);
+    if (it == m_entries.constEnd()) {
+        if (errorMessage) {
+            *errorMessage = "Запись не найдена: " + name;
+        }
+        return false;
+    }
+
+    // The output only appears under its name once the checksum has matched.
+    QSaveFile outputFile(outputFilePath);
+    if (!outputFile.open(QIODevice::WriteOnly)) {
+        if (errorMessage) {
+            *errorMessage = "Не удалось создать выходной файл: " + outputFilePath;
+        }
+        return false;
+    }
+
+    if (!copyEntry(*it, xorKey, &outputFile, errorMessage)) {
+        outputFile.cancelWriting();
+        return false;
+    }
+
+    outputFile.flush();
+    outputFile.setFileTime(QDateTime::fromMSecsSinceEpoch(it->modifiedMs), QFileDevice::FileModificationTime);
+
+    if (!outputFile.commit()) {
+        if (errorMessage) {
+            *errorMessage = "Ошибка записи извлечённых данных: " + outputFilePath;
+        }
+        return false;
+    }
+    return true;
+}
+
+// The checksum covers the payload as stored and is accumulated while the entry
+// is decoded, so a mismatch is only known once everything has been written:
+// callers discard the output whenever this returns false. Compressed entries
+// are decompressed too when a key is given; without one the stored bytes are
+// copied as they are.
+bool SegmentReader::copyEntry(const SegmentEntry& entry, const QByteArray& xorKey,
+                              QIODevice* output, QString* errorMessage) const
+{
+    QFile dataFile(m_directory.absoluteFilePath(SegmentFormat::dataFileName(entry.segmentNumber)));
+    if (!dataFile.open(QIODevice::ReadOnly) || !dataFile.seek(entry.offset)) {
+        if (errorMessage) {
+            *errorMessage = "Не удалось открыть сегмент: " + dataFile.fileName();
+        }
+        return false;
+    }
+
+    QByteArray buffer(bufferSize, Qt::Uninitialized);
+    quint32 checksum = 0;
+    qint64 position = 0;
+
+    std::optional<ChunkDecoder> decoder;
+    if ((entry.flags & SegmentEntry::Compressed) && !xorKey.isEmpty()) {
+        decoder.emplace(xorKey, [output](const char* data, qint64 size) {
+            return output->write(data, size) == size;
+        });
+    }
+
+    while (position < entry.length) {
+        const qint64 chunkSize = qMin(bufferSize, entry.length - position);
+
+        if (dataFile.read(buffer.data(), chunkSize) != chunkSize) {
+            if (errorMessage) {
+                *errorMessage = "Ошибка чтения из сегмента: " + dataFile.fileName();
+            }
+            return false;
+        }
+
+        checksum = Crc32::update(checksum, buffer.constData(), chunkSize);
+
+        bool isWritten = false;
+        if (decoder) {
+            isWritten = decoder->write(buffer.constData(), chunkSize);
+        } else {
+            XorCodec::apply(buffer.data(), chunkSize, xorKey, position);
+            isWritten = output->write(buffer.constData(), chunkSize) == chunkSize;
+        }
+
+        if (!isWritten) {
+            if (errorMessage) {
+                *errorMessage = "Ошибка записи извлечённых данных: " + entry.name;
+            }
+            return false;
+        }
+
+        position += chunkSize;
+    }
+
+    if (decoder && !decoder->finish()) {
+        if (errorMessage) {
+            *errorMessage = decoder->errorString() + ": " + entry.name;
+        }
+        return false;
+    }
+
+    if (checksum != entry.checksum) {
+        if (errorMessage) {
+            *errorMessage = "Контрольная сумма не совпадает: " + entry.name;
+        }
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef SEGMENTREADER_H
+#define SEGMENTREADER_H
+
+#include <QDir>
+#include <QHash>
+#include <QStringList>
+#include "segmentformat.h"
+
+// Loads the indexes of a packed output directory and gives random access to
+// entries by name. When the same name was packed more than once, the most
+// recent entry wins.
+class SegmentReader
+{
+public:
+    SegmentReader() = default;
+
+    bool open(const QString& directoryPath, QString* errorMessage = nullptr);
+
+    QStringList entryNames() const { return m_entries.keys(); }
+    bool contains(const QString& name) const { return m_entries.contains(name); }
+    SegmentEntry entry(const QString& name) const { return m_entries.value(name); }
+
+    bool read(const QString& name, QByteArray* data,
+              const QByteArray& xorKey = QByteArray(), QString* errorMessage = nullptr) const;
+    bool extract(const QString& name, const QString& outputFilePath,
+                 const QByteArray& xorKey = QByteArray(), QString* errorMessage = nullptr) const;
+
+private:
+    QDir m_directory;
+    QHash<QString, SegmentEntry> m_entries;
+
+    bool loadIndex(const QString& indexFilePath, QString* errorMessage);
+    bool copyEntry(const SegmentEntry& entry, const QByteArray& xorKey,
+                   QIODevice* output, QString* errorMessage) const;
+};
+
+#endif // SEGMENTREADER_H
@@ -0,0 +1,225 @@
+#include "segmentwriter.h"
+#include "checksum.h"
+
+#include <QRegularExpression>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#endif
+
+namespace {
+
+// QFileDevice::flush only reaches the page cache.
+bool syncFile(QFile& file)
+{
+    if (!file.flush()) {
+        return false;
+    }
+#if defined(Q_OS_LINUX)
+    return ::fsync(file.handle()) == 0;
+#elif defined(Q_OS_WIN)
+    return ::_commit(file.handle()) == 0;
+#else
+    return true;
+#endif
+}
+
+bool syncDirectory(const QDir& directory)
+{
+#ifdef Q_OS_LINUX
+    int directoryFd = ::open(QFile::encodeName(directory.absolutePath()).constData(),
+                             O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directoryFd == -1) {
+        return false;
+    }
+    const bool isSynced = ::fsync(directoryFd) == 0;
+    ::close(directoryFd);
+    return isSynced;
+#else
+    Q_UNUSED(directory);
+    return true;
+#endif
+}
+
+} // namespace
+
+SegmentWriter::~SegmentWriter()
+{
+    close();
+}
+
+bool SegmentWriter::open(const QString& directoryPath, qint64 maxSegmentSize, QString* errorMessage)
+{
+    close();
+
+    m_directory = QDir(directoryPath);
+    m_maxSegmentSize = maxSegmentSize;
+
+    // Never append to segments from a previous run: start after the last one.
+    static const QRegularExpression segmentPattern("^segment-(\\d+)\\.xpk$");
+    int lastSegmentNumber = 0;
+    for (const QString& fileName : m_directory.entryList(QStringList() << "segment-*.xpk", QDir::Files)) {
+        QRegularExpressionMatch match = segmentPattern.match(fileName);
+        if (match.hasMatch()) {
+            lastSegmentNumber = qMax(lastSegmentNumber, match.captured(1).toInt());
+        }
+    }
+
+    return openSegment(lastSegmentNumber + 1, errorMessage);
+}
+
+void SegmentWriter::close()
+{
+    if (m_isEntryOpen) {
+        abortEntry();
+    }
+    m_dataFile.close();
+    m_indexFile.close();
+}
+
+bool SegmentWriter::beginEntry(const QString& name, const QDateTime& modified, quint32 flags,
+                               QString* errorMessage)
+{
+    if (!isOpen()) {
+        if (errorMessage) {
+            *errorMessage = "Сегмент для упакованного вывода не открыт";
+        }
+        return false;
+    }
+
+    if (m_dataFile.size() >= m_maxSegmentSize && m_dataFile.size() > SegmentFormat::headerSize) {
+        if (!openSegment(m_segmentNumber + 1, errorMessage)) {
+            return false;
+        }
+    }
+
+    m_entry = SegmentEntry();
+    m_entry.name = name;
+    m_entry.segmentNumber = m_segmentNumber;
+    m_entry.offset = m_dataFile.size();
+    m_entry.modifiedMs = modified.toMSecsSinceEpoch();
+    m_entry.flags = flags;
+    m_isEntryOpen = m_dataFile.seek(m_entry.offset);
+
+    if (!m_isEntryOpen && errorMessage) {
+        *errorMessage = "Ошибка позиционирования в сегменте: " + m_dataFile.fileName();
+    }
+    return m_isEntryOpen;
+}
+
+bool SegmentWriter::write(const char* data, qint64 size)
+{
+    if (!m_isEntryOpen || m_dataFile.write(data, size) != size) {
+        return false;
+    }
+
+    m_entry.checksum = Crc32::update(m_entry.checksum, data, size);
+    m_entry.length += size;
+    return true;
+}
+
+bool SegmentWriter::commitEntry(QString* errorMessage)
+{
+    if (!m_isEntryOpen) {
+        return false;
+    }
+
+    QByteArray record;
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream.setVersion(SegmentFormat::streamVersion);
+    stream << m_entry;
+
+    // A short record would make every later one unreadable, so a failed
+    // write is cut back to the last good record. In durable mode the payload
+    // is on disk before the record that points at it, and the record before
+    // the entry is reported as committed.
+    const qint64 indexSize = m_indexFile.size();
+    if (!(m_isDurable ? syncFile(m_dataFile) : m_dataFile.flush())
+        || m_indexFile.write(record) != record.size()
+        || (m_isDurable && !syncIndex())) {
+        if (errorMessage) {
+            *errorMessage = "Ошибка записи индекса сегмента: " + m_indexFile.fileName();
+        }
+        if (!m_indexFile.resize(indexSize) || !m_indexFile.seek(indexSize)) {
+            m_isEntryOpen = false;
+            rollOver();
+            return false;
+        }
+        abortEntry();
+        return false;
+    }
+
+    m_isEntryOpen = false;
+    return true;
+}
+
+// The directory is synced once per segment, so that the newly created files
+// themselves survive a crash.
+bool SegmentWriter::syncIndex()
+{
+    if (!syncFile(m_indexFile)) {
+        return false;
+    }
+    if (!m_isDirectorySynced) {
+        m_isDirectorySynced = syncDirectory(m_directory);
+    }
+    return m_isDirectorySynced;
+}
+
+void SegmentWriter::abortEntry()
+{
+    if (!m_isEntryOpen) {
+        return;
+    }
+
+    m_isEntryOpen = false;
+    m_dataFile.flush();
+    if (!m_dataFile.resize(m_entry.offset) || !m_dataFile.seek(m_entry.offset)) {
+        rollOver();
+    }
+}
+
+// The current segment could not be put back into a known state: leave it as
+// it is (its index only lists committed entries) and continue in a new one.
+// If that fails too the writer ends up closed and later entries report it.
+void SegmentWriter::rollOver()
+{
+    openSegment(m_segmentNumber + 1, nullptr);
+}
+
+bool SegmentWriter::openSegment(int segmentNumber, QString* errorMessage)
+{
+    m_dataFile.close();
+    m_indexFile.close();
+
+    m_segmentNumber = segmentNumber;
+    m_isDirectorySynced = false;
+    m_dataFile.setFileName(m_directory.absoluteFilePath(SegmentFormat::dataFileName(segmentNumber)));
+    m_indexFile.setFileName(m_directory.absoluteFilePath(SegmentFormat::indexFileName(segmentNumber)));
+
+    // The index is unbuffered: each record goes out in a single write.
+    if (!m_dataFile.open(QIODevice::WriteOnly)
+        || !m_indexFile.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        if (errorMessage) {
+            *errorMessage = "Не удалось создать сегмент: " + m_dataFile.fileName();
+        }
+        m_dataFile.close();
+        m_indexFile.close();
+        return false;
+    }
+
+    QDataStream dataHeader(&m_dataFile);
+    dataHeader.setVersion(SegmentFormat::streamVersion);
+    dataHeader << SegmentFormat::dataMagic << SegmentFormat::version;
+
+    QDataStream indexHeader(&m_indexFile);
+    indexHeader.setVersion(SegmentFormat::streamVersion);
+    indexHeader << SegmentFormat::indexMagic << SegmentFormat::version;
+
+    return true;
+}
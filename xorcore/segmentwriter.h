@@ -0,0 +1,49 @@
+#ifndef SEGMENTWRITER_H
+#define SEGMENTWRITER_H
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include "segmentformat.h"
+
+// Appends entries to the current segment and rolls over to a new one once it
+// grows past maxSegmentSize. An entry only becomes visible to readers when
+// commitEntry() writes its index record; abortEntry() truncates it away.
+class SegmentWriter
+{
+public:
+    SegmentWriter() = default;
+    ~SegmentWriter();
+
+    bool open(const QString& directoryPath, qint64 maxSegmentSize, QString* errorMessage = nullptr);
+    void close();
+    bool isOpen() const { return m_dataFile.isOpen(); }
+
+    // When durable, commitEntry() syncs the payload and its index record to
+    // disk, so the source of the entry may be deleted once it returns.
+    void setDurable(bool isDurable) { m_isDurable = isDurable; }
+
+    bool beginEntry(const QString& name, const QDateTime& modified, quint32 flags = 0,
+                    QString* errorMessage = nullptr);
+    bool write(const char* data, qint64 size);
+    bool commitEntry(QString* errorMessage = nullptr);
+    void abortEntry();
+
+private:
+    QDir m_directory;
+    qint64 m_maxSegmentSize = 0;
+    int m_segmentNumber = 0;
+    bool m_isDurable = false;
+    bool m_isDirectorySynced = false;
+    QFile m_dataFile;
+    QFile m_indexFile;
+
+    SegmentEntry m_entry;
+    bool m_isEntryOpen = false;
+
+    bool openSegment(int segmentNumber, QString* errorMessage);
+    void rollOver();
+    bool syncIndex();
+};
+
+#endif // SEGMENTWRITER_H
@@ -0,0 +1,69 @@
+#include "xorcodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Eight-byte keys (the only size the GUI produces) are XORed a word at a
+// time with the key rotated to the starting phase; other lengths fall back
+// to the byte loop.
+void applyWordKey(char* data, size_t size, const char* key, size_t phase)
+{
+    char rotated[8];
+    for (size_t i = 0; i != 8; ++i) {
+        rotated[i] = key[(phase + i) % 8];
+    }
+    quint64 word;
+    std::memcpy(&word, rotated, sizeof(word));
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        quint64 value;
+        std::memcpy(&value, data + i, sizeof(value));
+        value ^= word;
+        std::memcpy(data + i, &value, sizeof(value));
+    }
+    for (size_t j = 0; i != size; ++i, ++j) {
+        data[i] ^= rotated[j];
+    }
+}
+
+} // namespace
+
+void XorCodec::apply(std::span<char> data, std::span<const char> key, qint64 offset)
+{
+    const size_t keyLength = key.size();
+    if (keyLength == 0 || data.empty()) {
+        return;
+    }
+
+    size_t keyIndex = static_cast<size_t>(offset % static_cast<qint64>(keyLength));
+
+    if (keyLength == 8) {
+        applyWordKey(data.data(), data.size(), key.data(), keyIndex);
+        return;
+    }
+
+    for (char& byte : data) {
+        byte ^= key[keyIndex];
+        if (++keyIndex == keyLength) {
+            keyIndex = 0;
+        }
+    }
+}
+
+void XorCodec::transform(std::span<const char> source, std::span<char> destination,
+                         std::span<const char> key, qint64 offset)
+{
+    Q_ASSERT(destination.size() >= source.size());
+    if (destination.data() != source.data()) {
+        std::copy(source.begin(), source.end(), destination.begin());
+    }
+    apply(destination.first(source.size()), key, offset);
+}
+
+bool XorCodec::isNeutralKey(std::span<const char> key)
+{
+    return std::all_of(key.begin(), key.end(), [](char byte) { return byte == 0; });
+}
@@ -0,0 +1,41 @@
+#ifndef XORCODEC_H
+#define XORCODEC_H
+
+#include <QByteArray>
+
+#include <span>
+
+// The XOR transform on plain memory. offset is the position of data within
+// the stream, so the key phase stays correct however the stream is chunked
+// or seeked. XOR is its own inverse: the same call encodes and decodes.
+class XorCodec
+{
+public:
+    static void apply(std::span<char> data, std::span<const char> key, qint64 offset = 0);
+
+    static void apply(char* data, qint64 size, const QByteArray& key, qint64 offset = 0)
+    {
+        apply(std::span<char>(data, static_cast<size_t>(size)), keySpan(key), offset);
+    }
+
+    static void apply(QByteArray& data, const QByteArray& key, qint64 offset = 0)
+    {
+        apply(data.data(), data.size(), key, offset);
+    }
+
+    // Copies source into destination (same size) and XORs in one pass.
+    static void transform(std::span<const char> source, std::span<char> destination,
+                          std::span<const char> key, qint64 offset = 0);
+
+    // A key that leaves data unchanged (all zero bytes, or empty).
+    static bool isNeutralKey(std::span<const char> key);
+
+    static bool isNeutralKey(const QByteArray& key) { return isNeutralKey(keySpan(key)); }
+
+    static std::span<const char> keySpan(const QByteArray& key)
+    {
+        return std::span<const char>(key.constData(), static_cast<size_t>(key.size()));
+    }
+};
+
+#endif // XORCODEC_H
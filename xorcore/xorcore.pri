@@ -0,0 +1,15 @@
+# Include from a project that links the xorcore static library. Build it
+# through FileXorProcessor.pro so the library is built first.
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+XORCORE_BUILD_DIR = $$shadowed($$PWD)
+win32:CONFIG(release, debug|release): XORCORE_BUILD_DIR = $$XORCORE_BUILD_DIR/release
+else:win32:CONFIG(debug, debug|release): XORCORE_BUILD_DIR = $$XORCORE_BUILD_DIR/debug
+
+LIBS += -L$$XORCORE_BUILD_DIR -lxorcore
+win32-g++|!win32: PRE_TARGETDEPS += $$XORCORE_BUILD_DIR/libxorcore.a
+else: PRE_TARGETDEPS += $$XORCORE_BUILD_DIR/xorcore.lib
+
+numa: LIBS += -lnuma
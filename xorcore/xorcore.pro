@@ -0,0 +1,35 @@
+# Static library with the XOR engine: the span-based XorCodec, XorIODevice,
+# the compressed stream codec and the packed segment format. The GUI and the
+# command-line tools link against it; other in-process consumers can do the same.
+
+QT       = core concurrent
+
+TEMPLATE = lib
+CONFIG += staticlib c++23
+
+TARGET = xorcore
+
+# qmake CONFIG+=numa places NUMA-local buffers through libnuma instead of
+# first touch; the application then links -lnuma as well.
+numa: DEFINES += XORCORE_HAVE_LIBNUMA
+
+SOURCES += \
+    checksum.cpp \
+    chunkcodec.cpp \
+    cputopology.cpp \
+    segmentreader.cpp \
+    segmentwriter.cpp \
+    xorcodec.cpp \
+    xoriodevice.cpp \
+    xorpipe.cpp
+
+HEADERS += \
+    checksum.h \
+    chunkcodec.h \
+    cputopology.h \
+    segmentformat.h \
+    segmentreader.h \
+    segmentwriter.h \
+    xorcodec.h \
+    xoriodevice.h \
+    xorpipe.h
@@ -0,0 +1,186 @@
+#include "xoriodevice.h"
+#include "xorcodec.h"
+
+namespace {
+
+const qint64 maxWriteChunk = 64 * 1024; // 64Kb
+
+} // namespace
+
+XorIODevice::XorIODevice(QIODevice* device, const QByteArray& xorKey,
+                         qint64 keyOffset, QObject* parent)
+    : QIODevice(parent)
+    , m_device(device)
+    , m_key(xorKey)
+    , m_keyOffset(keyOffset)
+{
+    if (m_device) {
+        connect(m_device, &QIODevice::readyRead, this, &QIODevice::readyRead);
+        connect(m_device, &QIODevice::bytesWritten, this, &QIODevice::bytesWritten);
+        connect(m_device, &QIODevice::readChannelFinished, this, &QIODevice::readChannelFinished);
+    }
+}
+
+XorIODevice::~XorIODevice()
+{
+    if (isOpen()) {
+        close();
+    }
+}
+
+bool XorIODevice::open(OpenMode mode)
+{
+    if (!m_device) {
+        setErrorString("Нет устройства для чтения/записи");
+        return false;
+    }
+
+    // The underlying device buffers on its own; a second buffer here would
+    // make pos() drift from the device position the key phase depends on.
+    const OpenMode deviceMode = mode & ~OpenMode(Unbuffered);
+    if (!m_device->isOpen()) {
+        if (!m_device->open(deviceMode)) {
+            setErrorString(m_device->errorString());
+            return false;
+        }
+        m_isDeviceOpenedHere = true;
+    } else if ((m_device->openMode() & deviceMode & ReadWrite) != (deviceMode & ReadWrite)) {
+        setErrorString("Устройство открыто в несовместимом режиме");
+        return false;
+    }
+
+    m_readPosition = 0;
+    m_writePosition = 0;
+    if (!QIODevice::open(mode | Unbuffered)) {
+        return false;
+    }
+
+    // A device that was already open is picked up where it stands.
+    if (!m_device->isSequential() && !QIODevice::seek(m_device->pos())) {
+        QIODevice::close();
+        return false;
+    }
+    return true;
+}
+
+void XorIODevice::close()
+{
+    QIODevice::close();
+    if (m_device && m_isDeviceOpenedHere) {
+        m_device->close();
+    }
+    m_isDeviceOpenedHere = false;
+    m_writeBuffer.clear();
+}
+
+bool XorIODevice::isSequential() const
+{
+    return !m_device || m_device->isSequential();
+}
+
+qint64 XorIODevice::size() const
+{
+    return m_device ? m_device->size() : 0;
+}
+
+bool XorIODevice::seek(qint64 pos)
+{
+    if (!m_device || m_device->isSequential()) {
+        return false;
+    }
+    if (!m_device->seek(pos)) {
+        setErrorString(m_device->errorString());
+        return false;
+    }
+    return QIODevice::seek(pos);
+}
+
+bool XorIODevice::atEnd() const
+{
+    return !isOpen() || !m_device || m_device->atEnd();
+}
+
+qint64 XorIODevice::bytesAvailable() const
+{
+    if (!m_device) {
+        return 0;
+    }
+    if (m_device->isSequential()) {
+        return QIODevice::bytesAvailable() + m_device->bytesAvailable();
+    }
+    return QIODevice::bytesAvailable();
+}
+
+qint64 XorIODevice::bytesToWrite() const
+{
+    return m_device ? m_device->bytesToWrite() : 0;
+}
+
+bool XorIODevice::waitForReadyRead(int msecs)
+{
+    return m_device && m_device->waitForReadyRead(msecs);
+}
+
+bool XorIODevice::waitForBytesWritten(int msecs)
+{
+    return m_device && m_device->waitForBytesWritten(msecs);
+}
+
+qint64 XorIODevice::devicePosition(qint64 sequentialPosition) const
+{
+    return m_device->isSequential() ? sequentialPosition : m_device->pos();
+}
+
+qint64 XorIODevice::readData(char* data, qint64 maxSize)
+{
+    if (!m_device) {
+        return -1;
+    }
+
+    const qint64 position = devicePosition(m_readPosition);
+    const qint64 bytesRead = m_device->read(data, maxSize);
+    if (bytesRead < 0) {
+        setErrorString(m_device->errorString());
+        return -1;
+    }
+
+    XorCodec::apply(data, bytesRead, m_key, m_keyOffset + position);
+    if (m_device->isSequential()) {
+        m_readPosition += bytesRead;
+    }
+    return bytesRead;
+}
+
+// The caller's data is const, so it is XORed into a scratch buffer, at most
+// maxWriteChunk bytes at a time.
+qint64 XorIODevice::writeData(const char* data, qint64 maxSize)
+{
+    if (!m_device) {
+        return -1;
+    }
+
+    qint64 totalWritten = 0;
+    while (totalWritten < maxSize) {
+        const qint64 chunkSize = qMin(maxWriteChunk, maxSize - totalWritten);
+        m_writeBuffer.resize(chunkSize);
+
+        const qint64 position = devicePosition(m_writePosition);
+        XorCodec::transform(std::span<const char>(data + totalWritten, static_cast<size_t>(chunkSize)),
+                            std::span<char>(m_writeBuffer.data(), static_cast<size_t>(chunkSize)),
+                            XorCodec::keySpan(m_key), m_keyOffset + position);
+
+        const qint64 written = m_device->write(m_writeBuffer.constData(), chunkSize);
+        if (written < 0) {
+            setErrorString(m_device->errorString());
+            return totalWritten > 0 ? totalWritten : -1;
+        }
+        if (m_device->isSequential()) {
+            m_writePosition += written;
+        }
+        totalWritten += written;
+        if (written < chunkSize) {
+            break;
+        }
+    }
+    return totalWritten;
+}
@@ -0,0 +1,61 @@
+#ifndef XORIODEVICE_H
+#define XORIODEVICE_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QPointer>
+
+// Wraps another QIODevice and XORs everything read from or written to it, so
+// XORed data can be consumed or produced in-process without intermediate
+// files. Positions map one to one onto the underlying device: on a
+// random-access device seek() works as usual and the key phase always
+// follows the absolute offset. keyOffset is the stream position that offset 0
+// of the device corresponds to, for data cut out of a longer XOR stream. On a
+// sequential device the read and write directions each count from 0 at
+// open(), so a duplex device such as a socket keeps both phases right.
+//
+// The wrapper does not take ownership. If the device is not open yet, open()
+// opens it with the same mode and close() closes it again; a device that is
+// already open keeps its current position.
+class XorIODevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    explicit XorIODevice(QIODevice* device, const QByteArray& xorKey,
+                         qint64 keyOffset = 0, QObject* parent = nullptr);
+    ~XorIODevice() override;
+
+    QIODevice* device() const { return m_device; }
+    QByteArray key() const { return m_key; }
+    qint64 keyOffset() const { return m_keyOffset; }
+
+    bool open(OpenMode mode) override;
+    void close() override;
+
+    bool isSequential() const override;
+    qint64 size() const override;
+    bool seek(qint64 pos) override;
+    bool atEnd() const override;
+    qint64 bytesAvailable() const override;
+    qint64 bytesToWrite() const override;
+    bool waitForReadyRead(int msecs) override;
+    bool waitForBytesWritten(int msecs) override;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    QPointer<QIODevice> m_device;
+    QByteArray m_key;
+    qint64 m_keyOffset;
+    qint64 m_readPosition = 0;  // sequential devices only
+    qint64 m_writePosition = 0;
+    bool m_isDeviceOpenedHere = false;
+    QByteArray m_writeBuffer;
+
+    qint64 devicePosition(qint64 sequentialPosition) const;
+};
+
+#endif // XORIODEVICE_H
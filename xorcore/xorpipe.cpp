@@ -0,0 +1,276 @@
+#include "xorpipe.h"
+#include "cputopology.h"
+#include "xorcodec.h"
+
+#include <QFile>
+
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+void setError(QString* errorMessage, const QString& message)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+}
+
+#ifndef Q_OS_LINUX
+
+// Portable path: plain reads and writes through QFile.
+bool copyWithQFile(int inputFd, int outputFd, const QByteArray& xorKey, qint64 bufferSize,
+                   qint64* bytesTransferred, QString* errorMessage)
+{
+    QFile input;
+    QFile output;
+    if (!input.open(inputFd, QIODevice::ReadOnly | QIODevice::Unbuffered, QFile::DontCloseHandle)
+        || !output.open(outputFd, QIODevice::WriteOnly | QIODevice::Unbuffered, QFile::DontCloseHandle)) {
+        setError(errorMessage, "Не удалось открыть входной или выходной поток");
+        return false;
+    }
+
+    QByteArray buffer(bufferSize, Qt::Uninitialized);
+    qint64 offset = 0;
+
+    for (;;) {
+        const qint64 bytesRead = input.read(buffer.data(), buffer.size());
+        if (bytesRead == 0) {
+            break;
+        }
+        if (bytesRead < 0) {
+            setError(errorMessage, "Ошибка чтения из входного потока");
+            return false;
+        }
+
+        XorCodec::apply(buffer.data(), bytesRead, xorKey, offset);
+        if (output.write(buffer.constData(), bytesRead) != bytesRead) {
+            setError(errorMessage, "Ошибка записи в выходной поток");
+            return false;
+        }
+        offset += bytesRead;
+        if (bytesTransferred) {
+            *bytesTransferred = offset;
+        }
+    }
+
+    return output.flush();
+}
+
+#else
+
+bool isPipe(int fd)
+{
+    struct stat fileStat;
+    return ::fstat(fd, &fileStat) == 0 && S_ISFIFO(fileStat.st_mode);
+}
+
+// Unprivileged callers are capped by /proc/sys/fs/pipe-max-size, so the
+// request is halved until the kernel accepts it. Returns the resulting size.
+qint64 growPipe(int fd, qint64 size)
+{
+    qint64 currentSize = ::fcntl(fd, F_GETPIPE_SZ);
+    for (qint64 requested = size; requested > currentSize; requested /= 2) {
+        const int newSize = ::fcntl(fd, F_SETPIPE_SZ, static_cast<int>(requested));
+        if (newSize >= 0) {
+            return newSize;
+        }
+    }
+    return currentSize > 0 ? currentSize : 64 * 1024;
+}
+
+ssize_t readRetrying(int fd, char* data, size_t size)
+{
+    ssize_t result;
+    do {
+        result = ::read(fd, data, size);
+    } while (result < 0 && errno == EINTR);
+    return result;
+}
+
+bool writeAll(int fd, const char* data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+enum class SpliceResult { Done, Unsupported, Failed };
+
+SpliceResult spliceThrough(int inputFd, int outputFd, qint64 chunkSize, qint64* bytesTransferred)
+{
+    qint64 total = 0;
+    for (;;) {
+        const ssize_t moved = ::splice(inputFd, nullptr, outputFd, nullptr, static_cast<size_t>(chunkSize),
+                                       SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (moved == 0) {
+            return SpliceResult::Done;
+        }
+        if (moved < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return total == 0 && (errno == EINVAL || errno == ENOSYS) ? SpliceResult::Unsupported
+                                                                     : SpliceResult::Failed;
+        }
+        total += moved;
+        if (bytesTransferred) {
+            *bytesTransferred = total;
+        }
+    }
+}
+
+// Returns the number of bytes handed to the pipe, or -1 when vmsplice is not
+// usable here at all (nothing has been written then).
+qint64 vmspliceAll(int fd, char* data, size_t size)
+{
+    struct iovec vector;
+    vector.iov_base = data;
+    vector.iov_len = size;
+    qint64 total = 0;
+
+    while (vector.iov_len > 0) {
+        const ssize_t moved = ::vmsplice(fd, &vector, 1, 0);
+        if (moved < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return total == 0 && (errno == EINVAL || errno == ENOSYS) ? -1 : total;
+        }
+        vector.iov_base = static_cast<char*>(vector.iov_base) + moved;
+        vector.iov_len -= static_cast<size_t>(moved);
+        total += moved;
+    }
+    return total;
+}
+
+bool transformLinux(int inputFd, int outputFd, const QByteArray& xorKey, const XorPipe::Options& options,
+                    qint64* bytesTransferred, QString* errorMessage)
+{
+    const bool isInputPipe = isPipe(inputFd);
+    const bool isOutputPipe = isPipe(outputFd);
+
+    qint64 pipeSize = options.pipeSize;
+    if (isInputPipe) {
+        growPipe(inputFd, options.pipeSize);
+    }
+    if (isOutputPipe) {
+        pipeSize = growPipe(outputFd, options.pipeSize);
+    }
+
+    if (options.useSplice && XorCodec::isNeutralKey(xorKey) && (isInputPipe || isOutputPipe)) {
+        switch (spliceThrough(inputFd, outputFd, pipeSize, bytesTransferred)) {
+        case SpliceResult::Done:
+            return true;
+        case SpliceResult::Failed:
+            setError(errorMessage, QString("Ошибка передачи данных: %1").arg(std::strerror(errno)));
+            return false;
+        case SpliceResult::Unsupported:
+            break;
+        }
+    }
+
+    // Four chunks of half a pipe each: the ring is twice the pipe size.
+    const qint64 chunkSize = qMax<qint64>(CpuTopology::pageSize,
+                                          (pipeSize / 2) / CpuTopology::pageSize * CpuTopology::pageSize);
+    const int ringSize = 4;
+
+    struct Chunk
+    {
+        char* data = nullptr;
+        qint64 queuedUpTo = -1; // output position after this chunk was vmspliced
+    };
+    std::vector<Chunk> ring(ringSize);
+    for (Chunk& chunk : ring) {
+        chunk.data = CpuTopology::allocateOnNode(chunkSize, -1);
+    }
+    char* scratch = CpuTopology::allocateOnNode(chunkSize, -1);
+
+    bool useVmsplice = options.useVmsplice && isOutputPipe;
+    bool isSuccess = true;
+    qint64 offset = 0;
+    int next = 0;
+
+    for (;;) {
+        Chunk& chunk = ring[next];
+        // Still possibly referenced by the pipe: this round is copied instead.
+        const bool canLend = useVmsplice && (chunk.queuedUpTo < 0 || offset - chunk.queuedUpTo >= pipeSize);
+        char* buffer = canLend ? chunk.data : scratch;
+
+        const ssize_t bytesRead = readRetrying(inputFd, buffer, static_cast<size_t>(chunkSize));
+        if (bytesRead == 0) {
+            break;
+        }
+        if (bytesRead < 0) {
+            setError(errorMessage, QString("Ошибка чтения из входного потока: %1").arg(std::strerror(errno)));
+            isSuccess = false;
+            break;
+        }
+
+        XorCodec::apply(buffer, bytesRead, xorKey, offset);
+
+        qint64 lent = 0;
+        if (canLend) {
+            lent = vmspliceAll(outputFd, buffer, static_cast<size_t>(bytesRead));
+            if (lent < 0) {
+                useVmsplice = false;
+                lent = 0;
+            } else {
+                chunk.queuedUpTo = offset + bytesRead;
+                next = (next + 1) % ringSize;
+            }
+        }
+
+        if (lent < bytesRead && !writeAll(outputFd, buffer + lent, static_cast<size_t>(bytesRead - lent))) {
+            setError(errorMessage, QString("Ошибка записи в выходной поток: %1").arg(std::strerror(errno)));
+            isSuccess = false;
+            break;
+        }
+
+        offset += bytesRead;
+        if (bytesTransferred) {
+            *bytesTransferred = offset;
+        }
+    }
+
+    for (Chunk& chunk : ring) {
+        CpuTopology::freeOnNode(chunk.data, chunkSize, -1);
+    }
+    CpuTopology::freeOnNode(scratch, chunkSize, -1);
+    return isSuccess;
+}
+
+#endif // Q_OS_LINUX
+
+} // namespace
+
+bool XorPipe::run(int inputFd, int outputFd, const QByteArray& xorKey, const Options& options,
+                  qint64* bytesTransferred, QString* errorMessage)
+{
+    if (bytesTransferred) {
+        *bytesTransferred = 0;
+    }
+
+#ifdef Q_OS_LINUX
+    return transformLinux(inputFd, outputFd, xorKey, options, bytesTransferred, errorMessage);
+#else
+    return copyWithQFile(inputFd, outputFd, xorKey, options.pipeSize, bytesTransferred, errorMessage);
+#endif
+}
@@ -0,0 +1,35 @@
+#ifndef XORPIPE_H
+#define XORPIPE_H
+
+#include <QByteArray>
+#include <QString>
+
+// Streams everything from one file descriptor to another through the XOR
+// transform, for stdin/stdout pipelines and FIFOs. On Linux pipes are
+// enlarged to pipeSize (F_SETPIPE_SZ), a neutral key is spliced straight
+// through without touching user space, and otherwise the XORed data is
+// handed to an output pipe with vmsplice instead of being copied by write().
+//
+// vmsplice only lends pages to the pipe, so a buffer must not be reused
+// while the pipe may still reference it. Buffers come from a ring of at
+// least twice the pipe size and one is only reused once a full pipe's worth
+// of data has been queued after it; otherwise that chunk goes out through
+// write(). The guarantee covers this pipe only: if the reader splices the
+// pages onward instead of reading them (pv does by default), they may still
+// be referenced downstream. Disable vmsplice for such pipelines (or run
+// pv -C).
+class XorPipe
+{
+public:
+    struct Options
+    {
+        qint64 pipeSize = 1024 * 1024;
+        bool useSplice = true;
+        bool useVmsplice = true;
+    };
+
+    static bool run(int inputFd, int outputFd, const QByteArray& xorKey, const Options& options,
+                    qint64* bytesTransferred = nullptr, QString* errorMessage = nullptr);
+};
+
+#endif // XORPIPE_H